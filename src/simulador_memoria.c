@@ -12,27 +12,146 @@
  * Profesor: Dante Adolfo Muñoz Quintero
  */
 
+#define _GNU_SOURCE
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <limits.h>
+#include <ctype.h>
+
+#ifndef _WIN32
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+// io_uring sin liburing: solo hacen falta la cabecera del kernel y syscall()
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#endif
+#if defined(__NR_io_uring_setup) && defined(IORING_OFF_SQ_RING)
+#define SWAP_HAVE_IO_URING 1
+#else
+#define SWAP_HAVE_IO_URING 0
+#endif
 
 // ==================== CONSTANTES Y CONFIGURACIÓN ====================
 
 #define MAX_PROCESSES 50
-#define MAX_LOG_ENTRIES 1000
 #define MAX_LINE_LENGTH 256
 
+// Tabla de páginas multinivel: 512 entradas por nodo (9 bits por nivel, como
+// x86-64); la raíz toma los bits que sobran del número de página
+#define PT_LEVEL_BITS 9
+#define PT_LEVEL_ENTRIES (1 << PT_LEVEL_BITS)
+
+// Bits del marco y de la ranura de Swap en una entrada de la tabla de
+// páginas (con signo, -1 = ninguno): hasta 2^27 - 1 marcos y ranuras
+#define PTE_INDEX_BITS 28
+#define PTE_INDEX_MAX ((1 << (PTE_INDEX_BITS - 1)) - 1)
+
+// Orden máximo del asignador buddy (bloques de hasta 2^20 marcos)
+#define BUDDY_MAX_ORDER 20
+
+// Archivo binario del registro de eventos
+#define LOG_MAGIC "SMEVLOG1"
+#define LOG_VERSION 1
+
+// Severidades del registro de eventos (LOG_LEVEL). Cada nivel incluye a los
+// anteriores: TRACE registra también los aciertos de la TLB y de página.
+#define LOG_LEVEL_OFF 0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_INFO 2
+#define LOG_LEVEL_DEBUG 3
+#define LOG_LEVEL_TRACE 4
+
+// Severidad máxima compilada. `make release` usa -DLOG_COMPILE_LEVEL=0: las
+// llamadas de registro desaparecen del binario y LOG_LEVEL no puede subirla.
+#ifndef LOG_COMPILE_LEVEL
+#define LOG_COMPILE_LEVEL LOG_LEVEL_TRACE
+#endif
+
+// Categorías del registro de eventos (LOG_CATEGORIES)
+#define LOG_CATEGORY_SYSTEM 0x01   // SISTEMA
+#define LOG_CATEGORY_PROCESS 0x02  // PROCESOS
+#define LOG_CATEGORY_ACCESS 0x04   // ACCESOS
+#define LOG_CATEGORY_SWAP 0x08     // SWAP
+#define LOG_CATEGORY_MEMORY 0x10   // MEMORIA
+#define LOG_CATEGORY_ALL 0x1f
+#define LOG_CATEGORY_COUNT 5
+
+// Formato binario de trazas
+#define TRACE_MAGIC "SMTRACE1"
+#define TRACE_VERSION 1
+#define TRACE_WINDOW_BYTES (64UL * 1024 * 1024)   // Ventana de lectura anticipada
+
 // Configuración por defecto (se puede sobrescribir con config.ini)
-int RAM_SIZE = 2048;        // KB
-int SWAP_SIZE = 4096;       // KB
-int PAGE_SIZE = 256;        // KB
-int TLB_SIZE = 4;           // Número de entradas en TLB
+// Cada hilo tiene su propia copia: un barrido ejecuta varias instancias del
+// simulador a la vez y cada hilo se asocia a la suya con sim_attach().
+__thread int RAM_SIZE = 2048;         // KB
+__thread int SWAP_SIZE = 4096;        // KB
+__thread int PAGE_SIZE = 256;         // KB
+__thread int TLB_SIZE = 4;            // Número de entradas en TLB
+__thread int TLB_WAYS = 4;            // Vías por conjunto (TLB_SIZE = totalmente asociativa)
+__thread char REPLACEMENT[32] = "FIFO"; // Política de reemplazo: FIFO, LRU, CLOCK, SECOND_CHANCE, ARC, OPT
+__thread int CORES = 1;               // Núcleos simulados en --replay (un hilo y una TLB por núcleo)
+__thread int PAGE_TABLE_LEVELS = 1;   // 1 = tabla densa; 2 a 4 = tabla multinivel (radix) dispersa
+__thread int HUGE_PAGE_SIZE = 0;      // KB de una página grande (0 = solo páginas base)
+
+// Modelo de costos del reloj simulado (ns)
+__thread int COST_TLB_HIT = 1;        // Consulta a la TLB
+__thread int COST_PAGE_WALK = 100;    // Recorrido de la tabla de páginas (TLB miss)
+__thread int COST_RAM_ACCESS = 100;   // Acceso a la RAM
+__thread int COST_SWAP_READ = 1000;   // Lectura de una página desde Swap
+__thread int COST_SWAP_WRITE = 1000;  // Escritura de una página a Swap
+__thread int COST_SWAP_SEEK = 0;      // Posicionamiento cuando la ranura no sigue a la anterior
+
+// Arena de RAM real (opcional)
+__thread int RAM_ARENA = 0;           // 1 = respaldar los marcos con memoria de verdad
+__thread char RAM_ARENA_HUGEPAGES[16] = "NONE"; // NONE, MADVISE o HUGETLB
+__thread int RAM_ARENA_TOUCH = 64;    // Bytes tocados por acceso
+
+// Dispositivo de swap real (opcional)
+__thread char SWAP_FILE[MAX_LINE_LENGTH] = ""; // Archivo o dispositivo de bloques ("" = solo metadatos)
+__thread int SWAP_DIRECT = 0;         // 1 = abrir con O_DIRECT (sin caché de páginas del SO)
+__thread char SWAP_IO[16] = "SYNC";   // E/S del archivo de swap: SYNC, IO_URING o THREADS
+__thread int SWAP_QUEUE_DEPTH = 32;   // Peticiones asíncronas en curso como máximo
+__thread int SWAP_IO_THREADS = 4;     // Hilos de E/S (THREADS o si io_uring no está disponible)
+__thread int SWAP_CLUSTER = 8;        // Víctimas por pasada de reclamación (como máximo 1/8 de la RAM)
+
+// Reclamación en segundo plano (kswapd)
+__thread int KSWAPD = 0;              // 1 = hilo que mantiene marcos libres entre las marcas
+__thread int WATERMARK_LOW = 5;       // % de marcos libres que despierta a kswapd
+__thread int WATERMARK_HIGH = 10;     // % de marcos libres en el que kswapd se detiene
+
+// Lectura anticipada (readahead) en fallos de página
+__thread int READAHEAD_MAX = 8;       // Páginas prefetch por fallo como máximo (0 = desactivada)
+
+// Curva de fallos (--mrc)
+__thread double MRC_SAMPLE_RATE = 1.0; // Fracción de páginas muestreadas (SHARDS; 1 = exacta)
+
+// Registro de eventos
+__thread int LOG_RING_SIZE = 16384;   // Eventos en el anillo (se redondea a potencia de dos)
+__thread char LOG_FILE[MAX_LINE_LENGTH] = ""; // Archivo binario de eventos ("" = temporal/ninguno)
+__thread char LOG_LEVEL[16] = "TRACE";       // Severidad máxima registrada: OFF, ERROR, INFO, DEBUG o TRACE
+__thread char REPLAY_LOG_LEVEL[16] = "ERROR"; // LOG_LEVEL en --replay
+__thread char LOG_CATEGORIES[MAX_LINE_LENGTH] = "TODAS"; // Categorías registradas (lista separada por comas)
 
 // Variables calculadas
-int NUM_RAM_FRAMES;         // Número de marcos en RAM
-int NUM_SWAP_FRAMES;        // Número de marcos en Swap
+__thread int NUM_RAM_FRAMES;          // Número de marcos en RAM
+__thread int NUM_SWAP_FRAMES;         // Número de marcos en Swap
+__thread int TLB_SETS;                // Número de conjuntos de la TLB
+__thread int HUGE_PAGE_ORDER;         // Marcos por página grande = 2^orden (0 = desactivadas)
+__thread uint32_t LOG_EVENT_MASK;     // Bit por LogEventType activo según LOG_LEVEL y LOG_CATEGORIES
 
 // ==================== ESTRUCTURAS DE DATOS ====================
 
@@ -52,28 +171,45 @@ typedef enum {
     PROC_TERMINATED        // Proceso terminado
 } ProcessState;
 
-// Entrada de la tabla de páginas
+// Entrada de la tabla de páginas: 8 bytes empaquetados en dos palabras.
+// Una página en RAM puede conservar su ranura de Swap (caché de swap), así
+// que el marco y la ranura se guardan los dos. El número de página es el
+// índice de la entrada y los ticks van aparte, en PageTableCold.
 typedef struct {
-    int page_number;       // Número de página lógica
-    int frame_number;      // Número de marco físico (-1 si no está en RAM)
-    PageState state;       // Estado de la página
-    bool valid;            // Bit de validez
-    bool modified;         // Bit de modificación (dirty bit)
-    int swap_position;     // Posición en swap (-1 si no está en swap)
-    time_t last_access;    // Timestamp del último acceso (para LRU)
-    time_t load_time;      // Timestamp de carga (para FIFO)
+    signed int frame_number : PTE_INDEX_BITS;  // Marco físico (-1 si no está en RAM)
+    unsigned int state : 2;                    // Estado de la página (PageState)
+    unsigned int valid : 1;                    // Bit de validez
+    unsigned int modified : 1;                 // Bit de modificación (dirty bit)
+    signed int swap_position : PTE_INDEX_BITS; // Posición en swap (-1 si no está en swap)
+    unsigned int prefetched : 1;               // Traída por lectura anticipada y aún sin usar
+    unsigned int huge : 1;                     // Forma parte de una página grande residente
+    unsigned int : 2;
 } PageTableEntry;
 
+// Metadatos fríos de una página, en un arreglo paralelo al de las entradas:
+// se escriben pero ningún recorrido de la tabla los lee
+typedef struct {
+    unsigned long long last_access; // Tick lógico del último acceso
+    unsigned long long load_time;   // Tick lógico de carga
+} PageTableCold;
+
 // Bloque de Control de Proceso (PCB)
 typedef struct {
     int pid;                        // ID del proceso
     char name[32];                  // Nombre del proceso
-    int size;                       // Tamaño en KB
+    long long size;                 // Tamaño en KB
     int num_pages;                  // Número de páginas necesarias
     ProcessState state;             // Estado del proceso
-    PageTableEntry *page_table;     // Tabla de páginas
+    PageTableEntry *page_table;     // Tabla de páginas densa (PAGE_TABLE_LEVELS = 1)
+    void **pt_root;                 // Raíz de la tabla multinivel (NULL si es densa)
+    int pt_root_bits;               // Bits del número de página que indexan la raíz
+    size_t pt_bytes;                // Memoria ocupada por la tabla de páginas
     time_t creation_time;           // Tiempo de creación
-    int page_faults;                // Contador de fallos de página
+    unsigned long long page_faults; // Contador de fallos de página
+    int ra_last_page;               // Detector de paso: última página accedida
+    int ra_stride;                  // Paso entre accesos consecutivos
+    int ra_streak;                  // Repeticiones seguidas del mismo paso
+    int ra_window;                  // Ventana de lectura anticipada (páginas)
 } PCB;
 
 // Entrada de la TLB (Translation Lookaside Buffer)
@@ -82,86 +218,747 @@ typedef struct {
     int page_number;       // Número de página
     int frame_number;      // Número de marco
     bool valid;            // Entrada válida
-    time_t last_access;    // Para reemplazo en TLB
+    bool huge;             // Traduce una página grande (página y marco de su inicio)
+    unsigned long long last_access; // Marca de uso (LRU dentro del conjunto)
 } TLBEntry;
 
-// Marco de memoria (RAM o Swap)
+// Núcleo simulado: TLB privada y contadores del camino rápido (aciertos en
+// la TLB), que no toma el cerrojo global
+typedef struct {
+    TLBEntry *tlb;                  // TLB_SETS conjuntos de TLB_WAYS vías
+    unsigned long long tlb_clock;   // Reloj lógico para el LRU de la TLB
+#ifndef _WIN32
+    pthread_mutex_t tlb_lock;       // La TLB frente a shootdowns de otros núcleos
+#endif
+    unsigned long long accesses;    // Accesos ejecutados en el núcleo
+    unsigned long long tlb_hits;
+    unsigned long long tlb_misses;
+    unsigned long long tlb_huge_hits; // Aciertos sobre entradas de páginas grandes
+    unsigned long long shootdowns;  // Entradas invalidadas por otros núcleos
+    unsigned long long sim_time_ns; // Costo de los accesos resueltos en la TLB
+    unsigned long long arena_bytes_touched;
+    uint64_t arena_sink;
+} Core;
+
+// Tabla de marcos (RAM o Swap) como estructura de arreglos: los recorridos
+// por dueño solo leen pid[] y el tick de carga va en su propio arreglo
+typedef struct {
+    int *pid;              // PID del proceso que ocupa el marco (-1 si libre)
+    int *page_number;      // Número de página del proceso
+    unsigned long long *load_time; // Tick lógico de carga
+} FrameTable;
+
+// Mapa de bits jerárquico de marcos libres (bit = 1 -> marco libre)
+// El nivel 1 (summary) tiene un bit por palabra del nivel 0 con algún
+// marco libre, así la búsqueda salta 4096 marcos ocupados por palabra.
+typedef struct {
+    uint64_t *words;       // Nivel 0: un bit por marco
+    uint64_t *summary;     // Nivel 1: un bit por palabra de nivel 0
+    int num_bits;          // Número de marcos
+    int num_words;         // Palabras de nivel 0
+    int num_summary;       // Palabras de nivel 1
+    int free_count;        // Marcos libres
+    int hint;              // Primera palabra de nivel 1 que puede tener bits
+    int run_cursor;        // Palabra donde empieza la próxima búsqueda de rachas
+} FrameBitmap;
+
+// Política de reemplazo de páginas
+// Los ganchos reciben índices de marcos de RAM; occupy_ram_frame() y
+// release_ram_frame() llaman a on_load/on_free y access_page() a on_access;
+// swap_out_page() llama a on_evict antes de liberar el marco expulsado.
+// La reclamación por lotes aísla cada víctima con on_free antes de expulsarla,
+// así que on_free debe tolerar marcos ya liberados y on_evict marcos aislados.
+// Una página grande solo se registra por el primer marco de su bloque.
+typedef struct {
+    const char *name;
+    void (*init)(int num_frames);
+    void (*destroy)(void);
+    void (*on_load)(int frame_index);     // Página cargada en el marco
+    void (*on_access)(int frame_index);   // Acceso a la página (NULL si no se usa)
+    void (*on_free)(int frame_index);     // Marco liberado
+    void (*on_evict)(int frame_index);    // Página expulsada a swap (NULL si no se usa)
+    int (*choose_victim)(int pid, int page_number); // Víctima para la página entrante
+    bool shared_access;                   // on_access toca listas compartidas (cerrojo global)
+} ReplacementPolicy;
+
+// Oráculo de Belady (OPT) construido a partir de la traza
+// next_use[i] es la posición del siguiente acceso a la misma página que el
+// registro i (OPT_NEVER si no vuelve a usarse).
+#define OPT_NEVER UINT64_MAX
+
+typedef struct {
+    uint64_t *next_use;                       // Siguiente uso por posición de la traza
+    uint64_t record_count;
+    uint64_t *first_use[MAX_PROCESSES + 1];   // Primer uso de cada página (PID de la traza)
+    uint64_t *next_pos[MAX_PROCESSES + 1];    // Próximo uso vigente de cada página
+    int num_pages[MAX_PROCESSES + 1];
+    int sim_to_trace[MAX_PROCESSES + 1];      // PID del simulador -> PID de la traza
+} OptOracle;
+
+// Entrada del montículo de OPT (máximo por próximo uso)
+typedef struct {
+    uint64_t key;          // Próximo uso de la página del marco
+    int frame;
+} OptHeapEntry;
+
+// Resultado de la ejecución de referencia con OPT
+typedef struct {
+    bool valid;
+    unsigned long long page_faults;
+    unsigned long long swap_reads;
+    unsigned long long swap_writes;
+} OptBaseline;
+
+// Lista enlazada por índices (marcos o nodos fantasma de ARC)
+typedef struct {
+    int head;              // LRU (-1 si vacía)
+    int tail;              // MRU
+    int size;
+} IndexList;
+
+// Asignador buddy de marcos de RAM (solo con páginas grandes)
+// Los marcos libres forman bloques alineados de 2^k marcos, con una lista
+// por orden. Un bloque se parte en dos mitades (buddies) para servir
+// órdenes menores y al liberar se une con su buddy si también está libre.
+typedef struct {
+    int max_order;         // Orden de una página grande
+    int8_t *order;         // Orden del bloque libre que empieza en el marco (-1 si no)
+    int *prev;             // Enlaces de las listas libres
+    int *next;
+    IndexList free[BUDDY_MAX_ORDER + 1]; // Bloques libres de cada orden
+} BuddyAllocator;
+
+// Muestra del objetivo adaptativo de ARC
+typedef struct {
+    unsigned long long tick;
+    int p;
+} ArcSample;
+
+#define ARC_HISTORY 16     // Muestras de p guardadas (espaciadas uniformemente)
+
+// Estado de ARC (Adaptive Replacement Cache)
+// T1/T2 son listas de marcos (vistas una vez / varias veces); B1/B2 son
+// listas fantasma con las páginas expulsadas recientemente de cada una.
+typedef struct {
+    IndexList t1, t2;
+    bool *in_t2;           // El marco está en T2
+    IndexList b1, b2;
+    uint64_t *ghost_key;   // (pid << 32) | página
+    int *ghost_prev;
+    int *ghost_next;       // También enlaza la lista de nodos libres
+    int *ghost_hnext;      // Cadena de la tabla hash
+    bool *ghost_in_b2;
+    int free_ghost;        // Primer nodo fantasma libre (-1 si no hay)
+    int *buckets;          // Tabla hash de fantasmas
+    uint64_t bucket_mask;
+    int capacity;          // c: marcos de RAM
+    int p;                 // Tamaño objetivo de T1
+    int p_min, p_max;
+    bool pending;          // p ya se adaptó en choose_victim para pending_key
+    uint64_t pending_key;
+    unsigned long long b1_hits, b2_hits;
+    ArcSample history[ARC_HISTORY];
+    int history_count;
+    unsigned long long sample_interval; // Ticks entre muestras (se duplica al llenarse)
+    unsigned long long next_sample;
+} ArcState;
+
+// Estado común de las políticas de reemplazo
+typedef struct {
+    int *prev;             // Lista doblemente enlazada de marcos (FIFO/LRU/Second-Chance)
+    int *next;
+    int head;              // Más antiguo / menos recientemente usado (-1 si vacía)
+    int tail;              // Más reciente
+    bool *referenced;      // Bit de referencia (CLOCK/Second-Chance)
+    bool *resident;        // Marco registrado en la política
+    int num_resident;      // Marcos registrados
+    int hand;              // Manecilla del reloj (CLOCK)
+    int num_frames;
+    uint64_t *frame_key;   // Próximo uso de la página de cada marco (OPT)
+    OptHeapEntry *heap;    // Montículo con borrado perezoso (OPT)
+    int heap_size;
+    int heap_capacity;
+    const OptOracle *oracle; // Oráculo de la traza (NULL fuera de reproducción)
+    ArcState arc;          // Estado de ARC
+} ReplacementState;
+
+// Backend de E/S del archivo de swap
+typedef enum {
+    SWAP_BACKEND_SYNC,     // pread/pwrite en el hilo del simulador
+    SWAP_BACKEND_URING,    // io_uring con llamadas al sistema directas
+    SWAP_BACKEND_THREADS   // Grupo de hilos de E/S
+} SwapIoBackend;
+
+// Petición de E/S asíncrona (como máximo una en curso por ranura)
+typedef struct {
+    int swap_index;        // Ranura (-1 si la entrada está libre)
+    bool write;
+    int pid;
+    int page_number;
+    unsigned char *buffer; // Búfer alineado propio
+    bool done;             // Terminada por el backend, pendiente de procesar
+    long result;           // Bytes transferidos (negativo si hubo error)
+    bool release_on_done;  // Liberar la ranura al terminar
+    struct timespec submitted;
+    struct timespec completed;
+} SwapRequest;
+
+#if SWAP_HAVE_IO_URING
+// Anillos de io_uring mapeados desde el kernel
+typedef struct {
+    int fd;
+    unsigned *sq_head, *sq_tail, *sq_mask, *sq_array;
+    unsigned *cq_head, *cq_tail, *cq_mask;
+    struct io_uring_sqe *sqes;
+    struct io_uring_cqe *cqes;
+    void *sq_ring;
+    void *cq_ring;
+    size_t sq_ring_size;
+    size_t cq_ring_size;   // 0 si comparte el mapeo con la cola de envío
+    size_t sqes_size;
+} IoUring;
+#endif
+
+// Dispositivo de swap respaldado por archivo
+// Cada ranura ocupa PAGE_SIZE KB en el desplazamiento ranura * PAGE_SIZE.
+typedef struct {
+    int fd;                         // -1 si no hay dispositivo
+    bool direct;                    // Abierto con O_DIRECT
+    size_t block_size;              // Bytes por página
+    unsigned char *buffer;          // Búfer alineado de una página (E/S síncrona)
+    SwapIoBackend backend;
+    SwapRequest *requests;          // Tabla de peticiones en curso
+    int queue_depth;
+    int in_flight;
+    int *slot_request;              // Ranura -> petición en curso (-1 si ninguna)
+    unsigned long long submitted;   // Peticiones enviadas al dispositivo
+    unsigned long long depth_sum;   // Suma de la profundidad de cola al enviar
+    int depth_max;
+    unsigned long long joins;       // Fallos que esperaron una lectura ya en curso
+    unsigned long long forwarded;   // Lecturas servidas desde una escritura en curso
+    unsigned long long deferred_releases; // Ranuras retenidas hasta terminar su E/S
+    struct timespec first_submit;   // Ventana para calcular IOPS
+    struct timespec last_complete;
+#if SWAP_HAVE_IO_URING
+    IoUring ring;
+#endif
+#ifndef _WIN32
+    pthread_t *threads;             // Grupo de hilos de E/S
+    int num_threads;
+    pthread_mutex_t lock;
+    pthread_cond_t work_ready;
+    pthread_cond_t work_done;
+    int *queue;                     // Cola circular de peticiones por atender
+    int queue_head;
+    int queue_count;
+    bool stopping;
+#endif
+    unsigned long long reads;
+    unsigned long long writes;
+    unsigned long long errors;      // Errores de E/S
+    unsigned long long mismatches;  // Páginas leídas con sello de otra página
+    unsigned long long read_ns;     // Latencia acumulada y máxima
+    unsigned long long write_ns;
+    unsigned long long read_ns_max;
+    unsigned long long write_ns_max;
+} SwapDevice;
+
+// Sello escrito al inicio de cada página en el dispositivo
+#define SWAP_STAMP_MAGIC 0x50415753u // "SWAP"
+
+typedef struct {
+    uint32_t magic;
+    int32_t pid;
+    int32_t page_number;
+    uint32_t reserved;
+} SwapPageStamp;
+
+// Tipos de evento del registro
+typedef enum {
+    EVENT_SYSTEM_INIT,        // Sistema inicializado
+    EVENT_PROCESS_CREATE,     // page_number = páginas, frame/swap_slot = en RAM/Swap, value = KB
+    EVENT_PROCESS_CREATE_LAZY,// Igual, con la tabla multinivel (páginas bajo demanda)
+    EVENT_PROCESS_EXIT,       // value = fallos de página del proceso
+    EVENT_TLB_HIT,
+    EVENT_PAGE_HIT,           // TLB miss con la página en RAM
+    EVENT_SWAP_IN,
+    EVENT_READAHEAD,          // Swap in anticipado
+    EVENT_ZERO_FILL,
+    EVENT_SWAP_OUT,
+    EVENT_SWAP_OUT_CLEAN,     // Expulsión con copia vigente en Swap
+    EVENT_HUGE_MAP,           // count = páginas, value = traídas de Swap
+    EVENT_HUGE_SWAP_OUT,      // count = páginas expulsadas, value = escritas
+    EVENT_SWAP_FULL,          // Sin ranura para la página
+    EVENT_HUGE_SWAP_FULL,     // Sin ranuras para la página grande (count = páginas)
+    EVENT_NO_FRAME,           // No se pudo liberar un marco de RAM
+    EVENT_SWAP_READ_ERROR,
+    EVENT_SWAP_WRITE_ERROR,
+    EVENT_HUGE_READ_ERROR,
+    EVENT_HUGE_WRITE_ERROR,
+    EVENT_SWAP_ASYNC_ERROR,   // value = 1 si era una escritura
+    EVENT_TYPE_COUNT
+} LogEventType;
+
+// Severidad y categoría de cada tipo de evento
+static const struct {
+    uint8_t level;
+    uint8_t category;
+} EVENT_CLASS[EVENT_TYPE_COUNT] = {
+    [EVENT_SYSTEM_INIT]         = { LOG_LEVEL_INFO,  LOG_CATEGORY_SYSTEM },
+    [EVENT_PROCESS_CREATE]      = { LOG_LEVEL_INFO,  LOG_CATEGORY_PROCESS },
+    [EVENT_PROCESS_CREATE_LAZY] = { LOG_LEVEL_INFO,  LOG_CATEGORY_PROCESS },
+    [EVENT_PROCESS_EXIT]        = { LOG_LEVEL_INFO,  LOG_CATEGORY_PROCESS },
+    [EVENT_TLB_HIT]             = { LOG_LEVEL_TRACE, LOG_CATEGORY_ACCESS },
+    [EVENT_PAGE_HIT]            = { LOG_LEVEL_TRACE, LOG_CATEGORY_ACCESS },
+    [EVENT_SWAP_IN]             = { LOG_LEVEL_DEBUG, LOG_CATEGORY_SWAP },
+    [EVENT_READAHEAD]           = { LOG_LEVEL_DEBUG, LOG_CATEGORY_SWAP },
+    [EVENT_ZERO_FILL]           = { LOG_LEVEL_DEBUG, LOG_CATEGORY_MEMORY },
+    [EVENT_SWAP_OUT]            = { LOG_LEVEL_DEBUG, LOG_CATEGORY_SWAP },
+    [EVENT_SWAP_OUT_CLEAN]      = { LOG_LEVEL_DEBUG, LOG_CATEGORY_SWAP },
+    [EVENT_HUGE_MAP]            = { LOG_LEVEL_DEBUG, LOG_CATEGORY_MEMORY },
+    [EVENT_HUGE_SWAP_OUT]       = { LOG_LEVEL_DEBUG, LOG_CATEGORY_SWAP },
+    [EVENT_SWAP_FULL]           = { LOG_LEVEL_ERROR, LOG_CATEGORY_SWAP },
+    [EVENT_HUGE_SWAP_FULL]      = { LOG_LEVEL_ERROR, LOG_CATEGORY_SWAP },
+    [EVENT_NO_FRAME]            = { LOG_LEVEL_ERROR, LOG_CATEGORY_MEMORY },
+    [EVENT_SWAP_READ_ERROR]     = { LOG_LEVEL_ERROR, LOG_CATEGORY_SWAP },
+    [EVENT_SWAP_WRITE_ERROR]    = { LOG_LEVEL_ERROR, LOG_CATEGORY_SWAP },
+    [EVENT_HUGE_READ_ERROR]     = { LOG_LEVEL_ERROR, LOG_CATEGORY_SWAP },
+    [EVENT_HUGE_WRITE_ERROR]    = { LOG_LEVEL_ERROR, LOG_CATEGORY_SWAP },
+    [EVENT_SWAP_ASYNC_ERROR]    = { LOG_LEVEL_ERROR, LOG_CATEGORY_SWAP },
+};
+
+// Evento del registro: 64 bytes de ancho fijo. Se guarda en binario y solo
+// se convierte a texto al mostrarlo o guardarlo. Los campos que no usa un
+// tipo de evento quedan en 0.
+typedef struct {
+    unsigned long long tick;  // Reloj lógico del simulador
+    long long value;          // Dato propio del tipo de evento
+    uint32_t seconds;         // Segundos desde el inicio del sistema
+    uint16_t type;            // LogEventType
+    uint16_t reserved;
+    int32_t pid;
+    int32_t page_number;
+    int32_t frame;            // Marco de RAM
+    int32_t swap_slot;        // Ranura de Swap
+    int32_t count;            // Páginas de una página grande
+    char name[20];            // Nombre del proceso (truncado)
+} LogEvent;
+
+// Registrar un evento de la severidad indicada. Por encima de
+// LOG_COMPILE_LEVEL la llamada no genera código; si no, cuesta una sola
+// comprobación de su bit en LOG_EVENT_MASK antes de construir el evento.
+// Los argumentos tras el tipo son los campos del LogEvent (.pid = ..., ...).
+#define LOG_EMIT(event_type, ...) \
+    do { \
+        if (__builtin_expect((LOG_EVENT_MASK >> (event_type)) & 1, 0)) { \
+            log_event(&(LogEvent){ .type = (event_type), __VA_ARGS__ }); \
+        } \
+    } while (0)
+#define LOG_DISCARD(event_type, ...) do { } while (0)
+
+#if LOG_COMPILE_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_ERROR LOG_EMIT
+#else
+#define LOG_ERROR LOG_DISCARD
+#endif
+#if LOG_COMPILE_LEVEL >= LOG_LEVEL_INFO
+#define LOG_INFO LOG_EMIT
+#else
+#define LOG_INFO LOG_DISCARD
+#endif
+#if LOG_COMPILE_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_DEBUG LOG_EMIT
+#else
+#define LOG_DEBUG LOG_DISCARD
+#endif
+#if LOG_COMPILE_LEVEL >= LOG_LEVEL_TRACE
+#define LOG_TRACE LOG_EMIT
+#else
+#define LOG_TRACE LOG_DISCARD
+#endif
+
+// Posición del anillo: sequence == índice + 1 cuando el evento está publicado
 typedef struct {
-    int pid;               // PID del proceso que ocupa el marco (-1 si libre)
-    int page_number;       // Número de página del proceso
-    bool occupied;         // Marco ocupado
-    time_t load_time;      // Tiempo de carga (para FIFO)
-} Frame;
+    uint64_t sequence;
+    LogEvent event;
+} LogSlot;
 
-// Cola FIFO para algoritmo de reemplazo
+// Cabecera del archivo de eventos; le siguen los LogEvent en orden
 typedef struct {
-    int *queue;            // Array de índices de marcos
-    int front;             // Frente de la cola
-    int rear;              // Final de la cola
-    int size;              // Tamaño actual
-    int capacity;          // Capacidad máxima
-} FIFOQueue;
-
-// Entrada de log
+    char magic[8];            // LOG_MAGIC
+    uint32_t version;         // LOG_VERSION
+    uint32_t record_size;     // sizeof(LogEvent)
+    int64_t start_time;       // time_t del inicio (base de LogEvent.seconds)
+} LogFileHeader;
+
+// Registro de eventos: anillo sin cerrojos con varios productores (núcleos,
+// kswapd) y un único consumidor que vacía el anillo al archivo
+typedef struct {
+    LogSlot *slots;
+    uint64_t mask;            // Tamaño del anillo - 1
+    uint64_t head;            // Siguiente posición por reservar (productores)
+    uint64_t tail;            // Siguiente posición por vaciar (consumidor)
+    uint64_t overflow;        // Eventos descartados con el anillo lleno
+    uint64_t stored;          // Eventos escritos en el archivo
+    FILE *file;               // NULL = los eventos solo viven en el anillo
+    bool temporary;           // Archivo temporal (se borra al cerrarlo)
+#ifndef _WIN32
+    pthread_mutex_t lock;     // Un solo consumidor a la vez (hilo de vaciado o lectura)
+    pthread_cond_t wait;      // Despierta al hilo de vaciado
+    pthread_t thread;
+#endif
+    bool running;             // Hilo de vaciado activo
+    bool stopping;
+} EventLog;
+
+// Configuración de una instancia (copia de las variables de configuración,
+// ya normalizadas por init_system)
 typedef struct {
-    time_t timestamp;
-    char message[256];
-} LogEntry;
+    int ram_size, swap_size, page_size;
+    int tlb_size, tlb_ways;
+    char replacement[32];
+    int cores;
+    int page_table_levels;
+    int huge_page_size;
+    int cost_tlb_hit, cost_page_walk, cost_ram_access;
+    int cost_swap_read, cost_swap_write, cost_swap_seek;
+    int ram_arena;
+    char ram_arena_hugepages[16];
+    int ram_arena_touch;
+    char swap_file[MAX_LINE_LENGTH];
+    int swap_direct;
+    char swap_io[16];
+    int swap_queue_depth, swap_io_threads, swap_cluster;
+    int kswapd, watermark_low, watermark_high;
+    int readahead_max;
+    double mrc_sample_rate;
+    int log_ring_size;
+    char log_file[MAX_LINE_LENGTH];
+    char log_level[16];
+    char log_categories[MAX_LINE_LENGTH];
+    int num_ram_frames, num_swap_frames, tlb_sets, huge_page_order;
+    uint32_t log_event_mask;
+} SimConfig;
 
 // Sistema de memoria
 typedef struct {
-    Frame *ram_frames;              // Marcos de RAM
-    Frame *swap_frames;             // Marcos de Swap
+    SimConfig config;               // Configuración con la que se creó
+    FrameTable ram_frames;          // Marcos de RAM
+    FrameTable swap_frames;         // Marcos de Swap
+    FrameBitmap ram_free;           // Marcos libres de RAM
+    FrameBitmap swap_free;          // Marcos libres de Swap
+    BuddyAllocator buddy;           // Bloques contiguos de RAM (con páginas grandes)
+    IndexList swap_cache;           // Ranuras de Swap con copia de una página en RAM (LRU)
+    int *swap_cache_prev;           // Enlaces de la lista de la caché de swap
+    int *swap_cache_next;
+    bool *swap_cached;              // La ranura está en la caché de swap
+    SwapDevice swap_dev;            // Archivo de swap real (opcional)
+    int *reclaim_batch;             // Víctimas de la pasada de reclamación en curso
+    int swap_last_slot;             // Última ranura leída o escrita (posición del cabezal)
+    int swap_last_write;            // Última ranura escrita (para medir rachas contiguas)
+#ifndef _WIN32
+    pthread_mutex_t lock;           // Cerrojo global (marcos, Swap, política, tablas)
+    pthread_cond_t kswapd_wait;     // Despierta a kswapd
+    pthread_t kswapd_thread;
+#endif
+    bool locking;                   // Hay más de un hilo (kswapd o varios núcleos)
+    unsigned long long lock_acquired;  // Veces que se tomó el cerrojo global
+    unsigned long long lock_contended; // Veces que hubo que esperarlo
+    bool kswapd_running;            // kswapd activo
+    bool kswapd_stopping;
+    bool kswapd_woken;              // Hay un despertar pendiente
+    int watermark_low;              // Marcos libres que despiertan a kswapd
+    int watermark_high;             // Marcos libres en los que kswapd se detiene
+    unsigned char *arena;           // Memoria de los marcos de RAM (NULL si no hay arena)
+    size_t arena_size;
+    const char *arena_pages;        // Páginas del SO que respaldan la arena
+    unsigned long long arena_bytes_touched; // Bytes leídos/escritos por accesos
+    unsigned long long arena_bytes_filled;  // Bytes copiados al traer páginas
     PCB *processes[MAX_PROCESSES];  // Procesos activos
     int num_processes;              // Número de procesos activos
-    TLBEntry *tlb;                  // TLB
-    FIFOQueue *fifo_queue;          // Cola FIFO para reemplazo
-    LogEntry *logs;                 // Sistema de logs
-    int log_count;                  // Contador de logs
-    int total_page_faults;          // Total de fallos de página
-    int total_swaps;                // Total de operaciones de swap
-    int total_tlb_hits;             // Total de aciertos en TLB
-    int total_tlb_misses;           // Total de fallos en TLB
-    int total_memory_accesses;      // Total de accesos a memoria
+    Core *cores;                    // Núcleos simulados, cada uno con su TLB
+    int num_cores;
+    const ReplacementPolicy *policy; // Política de reemplazo activa
+    ReplacementState repl;          // Estado de la política
+    EventLog events;                // Registro de eventos
+    unsigned long long total_page_faults;     // Total de fallos de página
+    unsigned long long total_swap_reads;      // Lecturas de swap (swap in)
+    unsigned long long total_swap_writes;     // Escrituras de swap (swap out)
+    unsigned long long total_clean_evictions; // Expulsiones limpias sin escritura
+    unsigned long long total_swap_cache_hits;   // Expulsiones resueltas por la caché de swap
+    unsigned long long total_swap_cache_misses; // Expulsiones que tuvieron que escribir
+    unsigned long long total_swap_cache_reclaims; // Ranuras recuperadas de la caché
+    unsigned long long total_reclaim_passes;    // Pasadas de reclamación de marcos
+    unsigned long long total_reclaimed;         // Marcos liberados por esas pasadas
+    unsigned long long total_direct_reclaims;   // Fallos que tuvieron que reclamar ellos mismos
+    unsigned long long total_kswapd_wakeups;    // Despertares de kswapd
+    unsigned long long total_kswapd_reclaims;   // Pasadas de reclamación de kswapd
+    unsigned long long total_kswapd_reclaimed;  // Marcos liberados por kswapd
+    unsigned long long kswapd_ns;               // Costo de E/S de kswapd (fuera de los fallos)
+    unsigned long long total_write_clusters;    // Rachas de escrituras en ranuras contiguas
+    unsigned long long total_swap_seeks;        // E/S que no siguen a la ranura anterior
+    unsigned long long total_readahead_batches; // Fallos que dispararon lectura anticipada
+    unsigned long long total_prefetched;        // Páginas traídas por adelantado
+    unsigned long long total_prefetch_hits;     // Prefetch usadas antes de expulsarse
+    unsigned long long total_prefetch_wasted;   // Prefetch expulsadas sin usarse
+    unsigned long long total_tlb_hits;        // Total de aciertos en TLB
+    unsigned long long total_tlb_misses;      // Total de fallos en TLB
+    unsigned long long total_tlb_shootdowns;  // Invalidaciones de una sola página
+    unsigned long long total_tlb_ipis;        // Shootdowns que alcanzaron a otro núcleo
+    unsigned long long total_tlb_huge_hits;   // Aciertos en entradas de páginas grandes
+    unsigned long long total_memory_accesses; // Total de accesos a memoria
+    unsigned long long total_page_walks;      // Recorridos de la tabla de páginas
+    unsigned long long total_walk_levels;     // Niveles leídos en esos recorridos
+    unsigned long long total_zero_fills;      // Primeros accesos servidos con un marco en cero
+    unsigned long long page_table_bytes;      // Memoria de las tablas de páginas vivas
+    unsigned long long page_table_peak;       // Máximo de esa memoria
+    unsigned long long total_huge_pages;      // Páginas grandes creadas (fallo o carga inicial)
+    unsigned long long total_huge_fallbacks;  // Regiones que no hallaron bloque contiguo
+    unsigned long long total_huge_evictions;  // Páginas grandes expulsadas enteras
+    int huge_resident;                        // Páginas grandes en RAM
+    unsigned long long tick;                  // Reloj lógico (un tick por acceso)
+    unsigned long long sim_time_ns;           // Reloj simulado según el modelo de costos
     time_t start_time;              // Tiempo de inicio
 } MemorySystem;
 
+// Resultado de un acceso a memoria
+typedef enum {
+    ACCESS_TLB_HIT,        // Traducción encontrada en TLB
+    ACCESS_PAGE_HIT,       // TLB miss, página presente en RAM
+    ACCESS_PAGE_FAULT,     // Fallo de página resuelto con swap in
+    ACCESS_ERROR           // Proceso/página inválidos o swap in fallido
+} AccessResult;
+
+// Registro de una traza de accesos
+typedef struct {
+    int pid;               // PID del proceso en la traza
+    int page_number;       // Página accedida
+    char op;               // 'r' = lectura, 'w' = escritura
+} TraceRecord;
+
+// Cabecera del archivo de traza binario
+// Le sigue una tabla de num_processes entradas TraceFileProcess y luego
+// record_count registros TraceFileRecord de ancho fijo.
+typedef struct {
+    char magic[8];         // TRACE_MAGIC
+    uint32_t version;      // TRACE_VERSION
+    uint32_t record_size;  // sizeof(TraceFileRecord)
+    uint64_t record_count; // Número de registros
+    uint32_t num_processes;// Entradas en la tabla de procesos
+    uint32_t reserved;
+} TraceFileHeader;
+
+// Entrada de la tabla de procesos (PID = índice + 1)
+typedef struct {
+    uint32_t num_pages;    // Páginas del proceso (0 si no aparece)
+    uint32_t reserved;
+} TraceFileProcess;
+
+// Registro empaquetado de la traza binaria
+typedef struct {
+    uint32_t page_number;
+    uint16_t pid;
+    uint8_t op;            // 'r' o 'w'
+    uint8_t reserved;
+} TraceFileRecord;
+
+// Lector de trazas (texto con fgets o binaria con mmap)
+typedef struct {
+    bool binary;
+    bool shared;                        // Cursor sobre el mapeo de otro lector
+    const char *filename;
+    FILE *file;                         // Traza de texto
+    unsigned long long line_number;
+    unsigned char *map;                 // Traza binaria mapeada
+    size_t map_size;
+    const TraceFileHeader *header;
+    const TraceFileProcess *process_table;
+    const TraceFileRecord *records;
+    uint64_t position;                  // Siguiente registro a leer
+    uint64_t window_end;                // Fin de la ventana con lectura anticipada
+} TraceReader;
+
+// Flujo de accesos de un núcleo en la reproducción multinúcleo
+typedef struct {
+    int core;                       // Núcleo que lo ejecuta
+    MemorySystem *system;           // Instancia a la que pertenece
+    TraceRecord *records;           // Accesos con el PID ya traducido al simulado
+    uint64_t count;
+    uint64_t capacity;
+    unsigned long long errors;      // Accesos con error
+#ifndef _WIN32
+    pthread_t thread;
+#endif
+} CoreStream;
+
+// Parámetros que admite una malla de barrido
+#define SWEEP_AXES 5
+#define SWEEP_MAX_VALUES 32
+static const char *SWEEP_KEYS[SWEEP_AXES] = {
+    "RAM_SIZE", "SWAP_SIZE", "PAGE_SIZE", "TLB_SIZE", "REPLACEMENT"
+};
+
+// Valores de un parámetro en la malla (sin valores = el de config.ini)
+typedef struct {
+    int count;
+    char values[SWEEP_MAX_VALUES][32];
+} SweepAxis;
+
+// Una configuración del barrido y su resultado
+typedef struct {
+    SimConfig config;
+    const char *status;             // "ok", "invalida" o "sin_memoria"
+    unsigned long long accesses;
+    unsigned long long errors;
+    unsigned long long page_faults;
+    unsigned long long swap_reads;
+    unsigned long long swap_writes;
+    unsigned long long tlb_hits;
+    unsigned long long tlb_misses;
+    unsigned long long sim_time_ns;
+    double seconds;
+} SweepRun;
+
+// Barrido en curso: los trabajadores toman la siguiente configuración libre
+typedef struct {
+    const TraceReader *trace;       // Traza binaria mapeada, compartida
+    const int *max_page;
+    SweepRun *runs;
+    int count;
+    int next;                       // Siguiente configuración por ejecutar
+    int done;                       // Configuraciones terminadas
+} Sweep;
+
+// Filas como máximo en el CSV de la curva de fallos
+#define MRC_MAX_ROWS 1000
+
+// Distancias de pila (Mattson) con un árbol de Fenwick sobre los tiempos de
+// último acceso: cada página vigente marca con 1 el tiempo de su último
+// acceso, así que las páginas distintas tocadas desde el acceso anterior a
+// una página son las marcas posteriores a él. Con LRU y F marcos el acceso
+// acierta si y solo si esa distancia (contando la propia página) es <= F.
+typedef struct {
+    uint32_t *last;                 // Último tiempo de cada página (0 = nunca)
+    uint32_t *owner;                // Página con su último acceso en cada tiempo
+    int32_t *tree;                  // Árbol de Fenwick de las marcas
+    uint32_t capacity;              // Tiempos disponibles antes de compactar
+    uint32_t now;                   // Último tiempo usado
+    uint32_t live;                  // Páginas con una marca vigente
+} StackDistance;
+
 // Variable global del sistema
-MemorySystem *mem_system = NULL;
+__thread MemorySystem *mem_system = NULL;
+
+// Núcleo en el que se ejecuta el hilo actual (-1 = hilo que no es un
+// núcleo, como kswapd: todos sus shootdowns son IPI)
+static __thread int current_core = 0;
+
+// Reloj lógico; los aciertos en TLB lo avanzan sin el cerrojo global
+static inline unsigned long long sim_tick(void) {
+    return __atomic_load_n(&mem_system->tick, __ATOMIC_RELAXED);
+}
+
+// Modo sin salida por pantalla (reproducción de trazas)
+__thread bool quiet_mode = false;
+
+// Fallos de la ejecución de referencia con OPT (--opt)
+__thread OptBaseline opt_baseline = { false, 0, 0, 0 };
 
 // ==================== PROTOTIPOS DE FUNCIONES ====================
 
 // Inicialización y configuración
 void load_config(const char *filename);
+void config_save(SimConfig *config);
+void config_apply(const SimConfig *config);
+void sim_attach(MemorySystem *system);
 void init_system();
 void free_system();
 
-// Cola FIFO
-FIFOQueue* create_fifo_queue(int capacity);
-void enqueue_fifo(FIFOQueue *queue, int frame_index);
-int dequeue_fifo(FIFOQueue *queue);
-bool is_fifo_empty(FIFOQueue *queue);
-void free_fifo_queue(FIFOQueue *queue);
+// Tabla de marcos (dueño de cada marco en arreglos separados)
+void frame_table_init(FrameTable *table, int num_frames);
+void frame_table_destroy(FrameTable *table);
+
+// Mapa de bits de marcos libres
+void bitmap_init(FrameBitmap *bitmap, int num_bits);
+void bitmap_destroy(FrameBitmap *bitmap);
+int bitmap_find_first(FrameBitmap *bitmap);
+int bitmap_find_run(FrameBitmap *bitmap, int length);
+void bitmap_set_used(FrameBitmap *bitmap, int index);
+void bitmap_set_free(FrameBitmap *bitmap, int index);
+
+// Asignador buddy de marcos de RAM
+bool buddy_init(BuddyAllocator *buddy, int num_frames, int max_order);
+void buddy_destroy(BuddyAllocator *buddy);
+int buddy_alloc(BuddyAllocator *buddy, int order);
+int buddy_peek(const BuddyAllocator *buddy);
+void buddy_take(BuddyAllocator *buddy, int frame_index);
+void buddy_free(BuddyAllocator *buddy, int frame_index);
+
+// Políticas de reemplazo
+const ReplacementPolicy* find_policy(const char *name);
+int select_victim_page(int pid, int page_number);
+int reclaim_ram_frames(int pid, int page_number);
+void kswapd_start();
+void kswapd_stop();
+void locking_start();
+void locking_stop();
+void mm_lock();
+void mm_unlock();
+void opt_attach_oracle(const OptOracle *oracle);
 
 // Gestión de procesos
-int create_process(const char *name, int size_kb);
+int create_process(const char *name, long long size_kb);
 bool terminate_process(int pid);
 PCB* find_process(int pid);
 
+// Tabla de páginas
+bool page_table_init(PCB *process);
+PageTableEntry* page_table_walk(PCB *process, int page_number, int *depth);
+PageTableEntry* page_table_lookup(PCB *process, int page_number);
+int page_table_next(PCB *process, int page_number);
+void page_table_destroy(PCB *process);
+
 // Gestión de memoria
 int allocate_page_in_ram(int pid, int page_number);
 int allocate_page_in_swap(int pid, int page_number);
 int find_free_ram_frame();
 int find_free_swap_frame();
-int select_victim_page_fifo();
+int allocate_swap_slot();
+bool arena_open();
+void arena_close();
+void arena_touch(int frame_index, bool write);
+void arena_fill(int frame_index);
+bool swap_device_open();
+void swap_device_close();
+bool swap_device_write(int swap_index, int pid, int page_number);
+bool swap_device_read(int swap_index, int pid, int page_number);
+bool swap_device_prefetch(int swap_index, int pid, int page_number);
+void swap_device_wait(int swap_index);
+bool swap_device_defer_release(int swap_index);
+const char* swap_io_backend_name(SwapIoBackend backend);
+void occupy_ram_frame(int frame_index, int pid, int page_number);
+void release_ram_frame(int frame_index);
+void occupy_swap_frame(int swap_index, int pid, int page_number);
+void release_swap_frame(int swap_index);
 bool swap_out_page(int frame_index);
 bool swap_in_page(int pid, int page_number);
+AccessResult access_page(int pid, int page_number, bool write);
+
+// Lectura anticipada
+void readahead_observe(PCB *process, int page_number);
+void readahead_batch(PCB *process, int page_number);
+void readahead_hit(PCB *process, PageTableEntry *entry);
+void readahead_wasted(PCB *process, PageTableEntry *entry);
 
 // TLB
 void init_tlb();
 int tlb_lookup(int pid, int page_number);
 void tlb_update(int pid, int page_number, int frame_number);
 void tlb_invalidate(int pid);
+void tlb_update_huge(int pid, int page_number, int frame_number);
+void tlb_invalidate_page(int pid, int page_number);
+void tlb_invalidate_huge(int pid, int page_number);
+void cores_fold_stats();
 
 // Visualización
 void display_memory_map();
@@ -171,11 +968,33 @@ void display_statistics();
 void display_tlb();
 
 // Logs
-void add_log(const char *message);
+void log_start();
+void log_stop();
+void log_event(const LogEvent *event);
 void display_logs(int count);
 void save_logs_to_file(const char *filename);
 
+// Reproducción de trazas
+int parse_trace_line(const char *line, TraceRecord *record);
+bool trace_open(TraceReader *reader, const char *filename);
+int trace_next(TraceReader *reader, TraceRecord *record);
+bool trace_collect_processes(TraceReader *reader, int max_page[]);
+void trace_rewind(TraceReader *reader);
+void trace_share(const TraceReader *source, TraceReader *cursor);
+void trace_close(TraceReader *reader);
+bool convert_trace(const char *text_file, const char *binary_file);
+bool opt_build_oracle(TraceReader *reader, const int max_page[], OptOracle *oracle);
+void opt_free_oracle(OptOracle *oracle);
+bool replay_trace(const char *filename, bool compare_opt);
+bool scale_trace(const char *filename, int max_cores);
+bool sweep_trace(const char *filename, const char *grid_file, const char *csv_file, int jobs);
+bool mrc_trace(const char *filename, const char *csv_file);
+
+// Banco de pruebas de la disposición en memoria
+bool bench_layout(int entries);
+
 // Menú y utilidades
+void print_usage(const char *program);
 void print_menu();
 void run_simulator();
 int get_user_input_int(const char *prompt);
@@ -197,7 +1016,7 @@ void load_config(const char *filename) {
         // Ignorar comentarios y líneas vacías
         if (line[0] == '#' || line[0] == '\n' || line[0] == '[') continue;
         
-        char key[64], value[64];
+        char key[MAX_LINE_LENGTH], value[MAX_LINE_LENGTH];
         if (sscanf(line, "%s = %s", key, value) == 2) {
             if (strcmp(key, "RAM_SIZE") == 0) {
                 RAM_SIZE = atoi(value);
@@ -207,6 +1026,75 @@ void load_config(const char *filename) {
                 PAGE_SIZE = atoi(value);
             } else if (strcmp(key, "TLB_SIZE") == 0) {
                 TLB_SIZE = atoi(value);
+            } else if (strcmp(key, "TLB_WAYS") == 0) {
+                TLB_WAYS = atoi(value);
+            } else if (strcmp(key, "REPLACEMENT") == 0 || 
+                       strcmp(key, "REPLACEMENT_ALGORITHM") == 0) {
+                strncpy(REPLACEMENT, value, sizeof(REPLACEMENT) - 1);
+                REPLACEMENT[sizeof(REPLACEMENT) - 1] = '\0';
+            } else if (strcmp(key, "CORES") == 0) {
+                CORES = atoi(value);
+            } else if (strcmp(key, "PAGE_TABLE_LEVELS") == 0) {
+                PAGE_TABLE_LEVELS = atoi(value);
+            } else if (strcmp(key, "HUGE_PAGE_SIZE") == 0) {
+                HUGE_PAGE_SIZE = atoi(value);
+            } else if (strcmp(key, "COST_TLB_HIT") == 0) {
+                COST_TLB_HIT = atoi(value);
+            } else if (strcmp(key, "COST_PAGE_WALK") == 0) {
+                COST_PAGE_WALK = atoi(value);
+            } else if (strcmp(key, "COST_RAM_ACCESS") == 0) {
+                COST_RAM_ACCESS = atoi(value);
+            } else if (strcmp(key, "COST_SWAP_READ") == 0) {
+                COST_SWAP_READ = atoi(value);
+            } else if (strcmp(key, "COST_SWAP_WRITE") == 0) {
+                COST_SWAP_WRITE = atoi(value);
+            } else if (strcmp(key, "COST_SWAP_SEEK") == 0) {
+                COST_SWAP_SEEK = atoi(value);
+            } else if (strcmp(key, "RAM_ARENA") == 0) {
+                RAM_ARENA = atoi(value);
+            } else if (strcmp(key, "RAM_ARENA_HUGEPAGES") == 0) {
+                strncpy(RAM_ARENA_HUGEPAGES, value, sizeof(RAM_ARENA_HUGEPAGES) - 1);
+                RAM_ARENA_HUGEPAGES[sizeof(RAM_ARENA_HUGEPAGES) - 1] = '\0';
+            } else if (strcmp(key, "RAM_ARENA_TOUCH") == 0) {
+                RAM_ARENA_TOUCH = atoi(value);
+            } else if (strcmp(key, "SWAP_FILE") == 0 && value[0] != '#') {
+                strncpy(SWAP_FILE, value, sizeof(SWAP_FILE) - 1);
+                SWAP_FILE[sizeof(SWAP_FILE) - 1] = '\0';
+            } else if (strcmp(key, "SWAP_DIRECT") == 0) {
+                SWAP_DIRECT = atoi(value);
+            } else if (strcmp(key, "SWAP_IO") == 0) {
+                strncpy(SWAP_IO, value, sizeof(SWAP_IO) - 1);
+                SWAP_IO[sizeof(SWAP_IO) - 1] = '\0';
+            } else if (strcmp(key, "SWAP_QUEUE_DEPTH") == 0) {
+                SWAP_QUEUE_DEPTH = atoi(value);
+            } else if (strcmp(key, "SWAP_IO_THREADS") == 0) {
+                SWAP_IO_THREADS = atoi(value);
+            } else if (strcmp(key, "SWAP_CLUSTER") == 0) {
+                SWAP_CLUSTER = atoi(value);
+            } else if (strcmp(key, "KSWAPD") == 0) {
+                KSWAPD = atoi(value);
+            } else if (strcmp(key, "WATERMARK_LOW") == 0) {
+                WATERMARK_LOW = atoi(value);
+            } else if (strcmp(key, "WATERMARK_HIGH") == 0) {
+                WATERMARK_HIGH = atoi(value);
+            } else if (strcmp(key, "READAHEAD_MAX") == 0) {
+                READAHEAD_MAX = atoi(value);
+            } else if (strcmp(key, "MRC_SAMPLE_RATE") == 0) {
+                MRC_SAMPLE_RATE = atof(value);
+            } else if (strcmp(key, "LOG_RING_SIZE") == 0) {
+                LOG_RING_SIZE = atoi(value);
+            } else if (strcmp(key, "LOG_FILE") == 0 && value[0] != '#') {
+                strncpy(LOG_FILE, value, sizeof(LOG_FILE) - 1);
+                LOG_FILE[sizeof(LOG_FILE) - 1] = '\0';
+            } else if (strcmp(key, "LOG_LEVEL") == 0) {
+                strncpy(LOG_LEVEL, value, sizeof(LOG_LEVEL) - 1);
+                LOG_LEVEL[sizeof(LOG_LEVEL) - 1] = '\0';
+            } else if (strcmp(key, "REPLAY_LOG_LEVEL") == 0) {
+                strncpy(REPLAY_LOG_LEVEL, value, sizeof(REPLAY_LOG_LEVEL) - 1);
+                REPLAY_LOG_LEVEL[sizeof(REPLAY_LOG_LEVEL) - 1] = '\0';
+            } else if (strcmp(key, "LOG_CATEGORIES") == 0) {
+                strncpy(LOG_CATEGORIES, value, sizeof(LOG_CATEGORIES) - 1);
+                LOG_CATEGORIES[sizeof(LOG_CATEGORIES) - 1] = '\0';
             }
         }
     }
@@ -215,941 +1103,5905 @@ void load_config(const char *filename) {
     printf("✓ Configuración cargada desde %s\n", filename);
 }
 
-// Crear cola FIFO
-FIFOQueue* create_fifo_queue(int capacity) {
-    FIFOQueue *queue = (FIFOQueue*)malloc(sizeof(FIFOQueue));
-    queue->queue = (int*)malloc(capacity * sizeof(int));
-    queue->front = 0;
-    queue->rear = -1;
-    queue->size = 0;
-    queue->capacity = capacity;
-    return queue;
+// Copiar la configuración del hilo actual
+void config_save(SimConfig *config) {
+    config->ram_size = RAM_SIZE;
+    config->swap_size = SWAP_SIZE;
+    config->page_size = PAGE_SIZE;
+    config->tlb_size = TLB_SIZE;
+    config->tlb_ways = TLB_WAYS;
+    strcpy(config->replacement, REPLACEMENT);
+    config->cores = CORES;
+    config->page_table_levels = PAGE_TABLE_LEVELS;
+    config->huge_page_size = HUGE_PAGE_SIZE;
+    config->cost_tlb_hit = COST_TLB_HIT;
+    config->cost_page_walk = COST_PAGE_WALK;
+    config->cost_ram_access = COST_RAM_ACCESS;
+    config->cost_swap_read = COST_SWAP_READ;
+    config->cost_swap_write = COST_SWAP_WRITE;
+    config->cost_swap_seek = COST_SWAP_SEEK;
+    config->ram_arena = RAM_ARENA;
+    strcpy(config->ram_arena_hugepages, RAM_ARENA_HUGEPAGES);
+    config->ram_arena_touch = RAM_ARENA_TOUCH;
+    strcpy(config->swap_file, SWAP_FILE);
+    config->swap_direct = SWAP_DIRECT;
+    strcpy(config->swap_io, SWAP_IO);
+    config->swap_queue_depth = SWAP_QUEUE_DEPTH;
+    config->swap_io_threads = SWAP_IO_THREADS;
+    config->swap_cluster = SWAP_CLUSTER;
+    config->kswapd = KSWAPD;
+    config->watermark_low = WATERMARK_LOW;
+    config->watermark_high = WATERMARK_HIGH;
+    config->readahead_max = READAHEAD_MAX;
+    config->mrc_sample_rate = MRC_SAMPLE_RATE;
+    config->log_ring_size = LOG_RING_SIZE;
+    strcpy(config->log_file, LOG_FILE);
+    strcpy(config->log_level, LOG_LEVEL);
+    strcpy(config->log_categories, LOG_CATEGORIES);
+    config->num_ram_frames = NUM_RAM_FRAMES;
+    config->num_swap_frames = NUM_SWAP_FRAMES;
+    config->tlb_sets = TLB_SETS;
+    config->huge_page_order = HUGE_PAGE_ORDER;
+    config->log_event_mask = LOG_EVENT_MASK;
 }
 
-// Agregar a cola FIFO
-void enqueue_fifo(FIFOQueue *queue, int frame_index) {
-    if (queue->size >= queue->capacity) {
-        return; // Cola llena
-    }
-    queue->rear = (queue->rear + 1) % queue->capacity;
-    queue->queue[queue->rear] = frame_index;
-    queue->size++;
+// Cargar una configuración en las variables del hilo actual
+void config_apply(const SimConfig *config) {
+    RAM_SIZE = config->ram_size;
+    SWAP_SIZE = config->swap_size;
+    PAGE_SIZE = config->page_size;
+    TLB_SIZE = config->tlb_size;
+    TLB_WAYS = config->tlb_ways;
+    strcpy(REPLACEMENT, config->replacement);
+    CORES = config->cores;
+    PAGE_TABLE_LEVELS = config->page_table_levels;
+    HUGE_PAGE_SIZE = config->huge_page_size;
+    COST_TLB_HIT = config->cost_tlb_hit;
+    COST_PAGE_WALK = config->cost_page_walk;
+    COST_RAM_ACCESS = config->cost_ram_access;
+    COST_SWAP_READ = config->cost_swap_read;
+    COST_SWAP_WRITE = config->cost_swap_write;
+    COST_SWAP_SEEK = config->cost_swap_seek;
+    RAM_ARENA = config->ram_arena;
+    strcpy(RAM_ARENA_HUGEPAGES, config->ram_arena_hugepages);
+    RAM_ARENA_TOUCH = config->ram_arena_touch;
+    strcpy(SWAP_FILE, config->swap_file);
+    SWAP_DIRECT = config->swap_direct;
+    strcpy(SWAP_IO, config->swap_io);
+    SWAP_QUEUE_DEPTH = config->swap_queue_depth;
+    SWAP_IO_THREADS = config->swap_io_threads;
+    SWAP_CLUSTER = config->swap_cluster;
+    KSWAPD = config->kswapd;
+    WATERMARK_LOW = config->watermark_low;
+    WATERMARK_HIGH = config->watermark_high;
+    READAHEAD_MAX = config->readahead_max;
+    MRC_SAMPLE_RATE = config->mrc_sample_rate;
+    LOG_RING_SIZE = config->log_ring_size;
+    strcpy(LOG_FILE, config->log_file);
+    strcpy(LOG_LEVEL, config->log_level);
+    strcpy(LOG_CATEGORIES, config->log_categories);
+    NUM_RAM_FRAMES = config->num_ram_frames;
+    NUM_SWAP_FRAMES = config->num_swap_frames;
+    TLB_SETS = config->tlb_sets;
+    HUGE_PAGE_ORDER = config->huge_page_order;
+    LOG_EVENT_MASK = config->log_event_mask;
 }
 
-// Remover de cola FIFO
-int dequeue_fifo(FIFOQueue *queue) {
-    if (queue->size == 0) {
-        return -1; // Cola vacía
-    }
-    int frame_index = queue->queue[queue->front];
-    queue->front = (queue->front + 1) % queue->capacity;
-    queue->size--;
-    return frame_index;
+// Asociar el hilo actual a una instancia del simulador (kswapd, núcleos y
+// trabajadores del barrido trabajan sobre el sistema de quien los creó)
+void sim_attach(MemorySystem *system) {
+    mem_system = system;
+    config_apply(&system->config);
 }
 
-// Verificar si cola está vacía
-bool is_fifo_empty(FIFOQueue *queue) {
-    return queue->size == 0;
+// Inicializar tabla de marcos con todos los marcos libres (pid = -1)
+void frame_table_init(FrameTable *table, int num_frames) {
+    table->pid = (int*)malloc(num_frames * sizeof(int));
+    table->page_number = (int*)malloc(num_frames * sizeof(int));
+    table->load_time = (unsigned long long*)calloc(num_frames, sizeof(unsigned long long));
+    
+    for (int i = 0; i < num_frames; i++) {
+        table->pid[i] = -1;
+        table->page_number[i] = -1;
+    }
 }
 
-// Liberar cola FIFO
-void free_fifo_queue(FIFOQueue *queue) {
-    free(queue->queue);
-    free(queue);
+// Liberar tabla de marcos
+void frame_table_destroy(FrameTable *table) {
+    free(table->pid);
+    free(table->page_number);
+    free(table->load_time);
+    table->pid = NULL;
+    table->page_number = NULL;
+    table->load_time = NULL;
 }
 
-// Inicializar TLB
-void init_tlb() {
-    mem_system->tlb = (TLBEntry*)malloc(TLB_SIZE * sizeof(TLBEntry));
-    for (int i = 0; i < TLB_SIZE; i++) {
-        mem_system->tlb[i].valid = false;
-        mem_system->tlb[i].pid = -1;
-        mem_system->tlb[i].page_number = -1;
-        mem_system->tlb[i].frame_number = -1;
-        mem_system->tlb[i].last_access = 0;
+// Inicializar mapa de bits con todos los marcos libres
+void bitmap_init(FrameBitmap *bitmap, int num_bits) {
+    bitmap->num_bits = num_bits;
+    bitmap->num_words = (num_bits + 63) / 64;
+    bitmap->num_summary = (bitmap->num_words + 63) / 64;
+    bitmap->words = (uint64_t*)calloc(bitmap->num_words + 1, sizeof(uint64_t));
+    bitmap->summary = (uint64_t*)calloc(bitmap->num_summary + 1, sizeof(uint64_t));
+    bitmap->free_count = 0;
+    bitmap->hint = 0;
+    bitmap->run_cursor = 0;
+    
+    for (int i = 0; i < num_bits; i++) {
+        bitmap_set_free(bitmap, i);
     }
 }
 
-// Buscar en TLB
-int tlb_lookup(int pid, int page_number) {
-    for (int i = 0; i < TLB_SIZE; i++) {
-        if (mem_system->tlb[i].valid && 
-            mem_system->tlb[i].pid == pid && 
-            mem_system->tlb[i].page_number == page_number) {
-            mem_system->tlb[i].last_access = time(NULL);
-            mem_system->total_tlb_hits++;
-            return mem_system->tlb[i].frame_number;
-        }
+// Liberar mapa de bits
+void bitmap_destroy(FrameBitmap *bitmap) {
+    free(bitmap->words);
+    free(bitmap->summary);
+    bitmap->words = NULL;
+    bitmap->summary = NULL;
+}
+
+// Buscar el primer marco libre (-1 si no hay)
+int bitmap_find_first(FrameBitmap *bitmap) {
+    if (bitmap->free_count == 0) {
+        return -1;
     }
-    mem_system->total_tlb_misses++;
-    return -1; // TLB miss
+    
+    // Avanzar la pista sobre palabras de nivel 1 ya agotadas
+    while (bitmap->hint < bitmap->num_summary && bitmap->summary[bitmap->hint] == 0) {
+        bitmap->hint++;
+    }
+    if (bitmap->hint >= bitmap->num_summary) {
+        return -1;
+    }
+    
+    int word = bitmap->hint * 64 + __builtin_ctzll(bitmap->summary[bitmap->hint]);
+    return word * 64 + __builtin_ctzll(bitmap->words[word]);
 }
 
-// Actualizar TLB
-void tlb_update(int pid, int page_number, int frame_number) {
-    // Buscar entrada vacía o la más antigua
-    int victim_index = 0;
-    time_t oldest_time = mem_system->tlb[0].last_access;
+// Buscar una racha de length marcos libres consecutivos (-1 si no hay).
+// Siguiente ajuste: la búsqueda empieza donde terminó la última racha, salta
+// con el nivel 1 las palabras sin marcos libres y recorre cada palabra por
+// tramos de unos con ctz, sin mirar los bits uno a uno.
+int bitmap_find_run(FrameBitmap *bitmap, int length) {
+    if (length <= 0 || bitmap->free_count < length || bitmap->num_words == 0) {
+        return -1;
+    }
     
-    for (int i = 0; i < TLB_SIZE; i++) {
-        if (!mem_system->tlb[i].valid) {
-            victim_index = i;
-            break;
+    // Una vuelta completa más las palabras que puede ocupar una racha que
+    // cruce el cursor
+    int first = bitmap->run_cursor < bitmap->num_words ? bitmap->run_cursor : 0;
+    int steps = bitmap->num_words + (length + 63) / 64;
+    int start = -1;
+    int run = 0;
+    for (int i = 0; i < steps; i++) {
+        int w = (first + i) % bitmap->num_words;
+        if (w == 0) run = 0; // Las rachas no dan la vuelta al final
+        
+        uint64_t summary = bitmap->summary[w / 64];
+        if (!(summary & (1ULL << (w % 64)))) {
+            run = 0;
+            if (summary == 0) {
+                // Saltar el resto de las palabras de este bloque de nivel 1
+                int skip = 63 - w % 64;
+                if (skip > bitmap->num_words - 1 - w) skip = bitmap->num_words - 1 - w;
+                i += skip;
+            }
+            continue;
         }
-        if (mem_system->tlb[i].last_access < oldest_time) {
-            oldest_time = mem_system->tlb[i].last_access;
-            victim_index = i;
+        
+        uint64_t word = bitmap->words[w];
+        if (word == ~0ULL) {
+            if (run == 0) start = w * 64;
+            run += 64;
+            if (run >= length) break;
+            continue;
+        }
+        
+        // Tramos de unos de la palabra, de menor a mayor bit
+        uint64_t rest = word;
+        while (rest) {
+            int bit = __builtin_ctzll(rest);
+            int len = __builtin_ctzll(~(rest >> bit)); // rest no es ~0: hay un cero
+            if (bit != 0) run = 0;
+            if (run == 0) start = w * 64 + bit;
+            run += len;
+            if (run >= length) break;
+            if (bit + len == 64) break; // El tramo sigue en la palabra siguiente
+            run = 0;
+            rest &= ~(((1ULL << len) - 1) << bit);
         }
+        if (run >= length) break;
     }
+    if (run < length) return -1;
     
-    // Actualizar entrada
-    mem_system->tlb[victim_index].pid = pid;
-    mem_system->tlb[victim_index].page_number = page_number;
-    mem_system->tlb[victim_index].frame_number = frame_number;
-    mem_system->tlb[victim_index].valid = true;
-    mem_system->tlb[victim_index].last_access = time(NULL);
+    bitmap->run_cursor = (start + length) / 64 % bitmap->num_words;
+    return start;
 }
 
-// Invalidar entradas de TLB de un proceso
-void tlb_invalidate(int pid) {
-    for (int i = 0; i < TLB_SIZE; i++) {
-        if (mem_system->tlb[i].valid && mem_system->tlb[i].pid == pid) {
-            mem_system->tlb[i].valid = false;
-        }
+// Marcar un marco como ocupado
+void bitmap_set_used(FrameBitmap *bitmap, int index) {
+    int word = index / 64;
+    uint64_t mask = 1ULL << (index % 64);
+    if (!(bitmap->words[word] & mask)) {
+        return;
+    }
+    
+    bitmap->words[word] &= ~mask;
+    bitmap->free_count--;
+    if (bitmap->words[word] == 0) {
+        bitmap->summary[word / 64] &= ~(1ULL << (word % 64));
     }
 }
 
-// Inicializar sistema de memoria
-void init_system() {
-    // Calcular número de marcos
-    NUM_RAM_FRAMES = RAM_SIZE / PAGE_SIZE;
-    NUM_SWAP_FRAMES = SWAP_SIZE / PAGE_SIZE;
-    
-    printf("\n╔════════════════════════════════════════════════════════════╗\n");
-    printf("║     INICIALIZANDO SIMULADOR DE GESTOR DE MEMORIA           ║\n");
-    printf("╚════════════════════════════════════════════════════════════╝\n\n");
-    
-    // Crear estructura del sistema
-    mem_system = (MemorySystem*)malloc(sizeof(MemorySystem));
-    
-    // Inicializar marcos de RAM
-    mem_system->ram_frames = (Frame*)malloc(NUM_RAM_FRAMES * sizeof(Frame));
-    for (int i = 0; i < NUM_RAM_FRAMES; i++) {
-        mem_system->ram_frames[i].pid = -1;
-        mem_system->ram_frames[i].page_number = -1;
-        mem_system->ram_frames[i].occupied = false;
-        mem_system->ram_frames[i].load_time = 0;
+// Marcar un marco como libre
+void bitmap_set_free(FrameBitmap *bitmap, int index) {
+    int word = index / 64;
+    uint64_t mask = 1ULL << (index % 64);
+    if (bitmap->words[word] & mask) {
+        return;
     }
     
-    // Inicializar marcos de Swap
-    mem_system->swap_frames = (Frame*)malloc(NUM_SWAP_FRAMES * sizeof(Frame));
-    for (int i = 0; i < NUM_SWAP_FRAMES; i++) {
-        mem_system->swap_frames[i].pid = -1;
-        mem_system->swap_frames[i].page_number = -1;
-        mem_system->swap_frames[i].occupied = false;
-        mem_system->swap_frames[i].load_time = 0;
+    bitmap->words[word] |= mask;
+    bitmap->free_count++;
+    bitmap->summary[word / 64] |= 1ULL << (word % 64);
+    if (word / 64 < bitmap->hint) {
+        bitmap->hint = word / 64;
     }
-    
-    // Inicializar procesos
-    mem_system->num_processes = 0;
-    for (int i = 0; i < MAX_PROCESSES; i++) {
-        mem_system->processes[i] = NULL;
+}
+
+// ==================== POLÍTICAS DE REEMPLAZO ====================
+
+// Inicializar el estado común (lista de marcos, bits de referencia, reloj)
+static void repl_init(int num_frames) {
+    ReplacementState *r = &mem_system->repl;
+    int n = num_frames > 0 ? num_frames : 1;
+    r->prev = (int*)malloc(n * sizeof(int));
+    r->next = (int*)malloc(n * sizeof(int));
+    r->referenced = (bool*)calloc(n, sizeof(bool));
+    r->resident = (bool*)calloc(n, sizeof(bool));
+    r->head = -1;
+    r->tail = -1;
+    r->num_resident = 0;
+    r->hand = 0;
+    r->num_frames = num_frames;
+    r->frame_key = NULL;
+    r->heap = NULL;
+    r->heap_size = 0;
+    r->heap_capacity = 0;
+    r->oracle = NULL;
+    memset(&r->arc, 0, sizeof(r->arc));
+}
+
+static void repl_destroy(void) {
+    ReplacementState *r = &mem_system->repl;
+    free(r->prev);
+    free(r->next);
+    free(r->referenced);
+    free(r->resident);
+    free(r->frame_key);
+    free(r->heap);
+    free(r->arc.in_t2);
+    free(r->arc.ghost_key);
+    free(r->arc.ghost_prev);
+    free(r->arc.ghost_next);
+    free(r->arc.ghost_hnext);
+    free(r->arc.ghost_in_b2);
+    free(r->arc.buckets);
+}
+
+// Agregar un marco al final de la lista
+static void list_push_back(int frame_index) {
+    ReplacementState *r = &mem_system->repl;
+    r->prev[frame_index] = r->tail;
+    r->next[frame_index] = -1;
+    if (r->tail != -1) r->next[r->tail] = frame_index;
+    else r->head = frame_index;
+    r->tail = frame_index;
+}
+
+// Quitar un marco de la lista
+static void list_remove(int frame_index) {
+    ReplacementState *r = &mem_system->repl;
+    int p = r->prev[frame_index];
+    int n = r->next[frame_index];
+    if (p != -1) r->next[p] = n;
+    else r->head = n;
+    if (n != -1) r->prev[n] = p;
+    else r->tail = p;
+}
+
+// Registrar un marco al final de la lista (FIFO, LRU, Second-Chance)
+static void list_on_load(int frame_index) {
+    ReplacementState *r = &mem_system->repl;
+    if (r->resident[frame_index]) list_remove(frame_index);
+    else r->num_resident++;
+    r->resident[frame_index] = true;
+    __atomic_store_n(&r->referenced[frame_index], false, __ATOMIC_RELAXED);
+    list_push_back(frame_index);
+}
+
+static void list_on_free(int frame_index) {
+    ReplacementState *r = &mem_system->repl;
+    if (!r->resident[frame_index]) return;
+    list_remove(frame_index);
+    r->resident[frame_index] = false;
+    r->num_resident--;
+}
+
+// FIFO/LRU: la víctima es la cabeza de la lista (más antigua o menos reciente)
+static int list_head_victim(int pid, int page_number) {
+    (void)pid; (void)page_number;
+    return mem_system->repl.head;
+}
+
+// LRU: cada acceso mueve el marco al final; la víctima es el menos reciente
+static void lru_on_access(int frame_index) {
+    if (!mem_system->repl.resident[frame_index]) return;
+    list_remove(frame_index);
+    list_push_back(frame_index);
+}
+
+// Second-Chance: FIFO que reencola las páginas referenciadas
+// Solo marca un bit: se puede llamar desde el camino rápido sin el cerrojo,
+// así que las búsquedas de víctima leen y limpian el bit de forma atómica
+static void reference_on_access(int frame_index) {
+    __atomic_store_n(&mem_system->repl.referenced[frame_index], true, __ATOMIC_RELAXED);
+}
+
+static int second_chance_choose_victim(int pid, int page_number) {
+    (void)pid; (void)page_number;
+    ReplacementState *r = &mem_system->repl;
+    while (r->head != -1) {
+        int frame_index = r->head;
+        if (!__atomic_exchange_n(&r->referenced[frame_index], false, __ATOMIC_RELAXED)) {
+            return frame_index;
+        }
+        list_remove(frame_index);
+        list_push_back(frame_index);
     }
-    
-    // Inicializar TLB
-    init_tlb();
-    
-    // Inicializar cola FIFO
-    mem_system->fifo_queue = create_fifo_queue(NUM_RAM_FRAMES);
-    
-    // Inicializar logs
-    mem_system->logs = (LogEntry*)malloc(MAX_LOG_ENTRIES * sizeof(LogEntry));
-    mem_system->log_count = 0;
-    
-    // Inicializar estadísticas
-    mem_system->total_page_faults = 0;
-    mem_system->total_swaps = 0;
-    mem_system->total_tlb_hits = 0;
-    mem_system->total_tlb_misses = 0;
-    mem_system->total_memory_accesses = 0;
-    mem_system->start_time = time(NULL);
-    
-    printf("✓ Memoria RAM inicializada: %d KB (%d marcos de %d KB)\n", 
-           RAM_SIZE, NUM_RAM_FRAMES, PAGE_SIZE);
-    printf("✓ Área de Swap inicializada: %d KB (%d marcos de %d KB)\n", 
-           SWAP_SIZE, NUM_SWAP_FRAMES, PAGE_SIZE);
-    printf("✓ TLB inicializada: %d entradas\n", TLB_SIZE);
-    printf("✓ Algoritmo de reemplazo: FIFO\n");
-    
-    add_log("Sistema de memoria inicializado correctamente");
+    return -1;
 }
 
-// Liberar sistema
-void free_system() {
-    if (!mem_system) return;
+// CLOCK: manecilla circular sobre los marcos de RAM
+static void clock_on_load(int frame_index) {
+    ReplacementState *r = &mem_system->repl;
+    if (!r->resident[frame_index]) r->num_resident++;
+    r->resident[frame_index] = true;
+    __atomic_store_n(&r->referenced[frame_index], false, __ATOMIC_RELAXED);
+}
+
+static void clock_on_free(int frame_index) {
+    ReplacementState *r = &mem_system->repl;
+    if (!r->resident[frame_index]) return;
+    r->resident[frame_index] = false;
+    r->num_resident--;
+}
+
+static int clock_choose_victim(int pid, int page_number) {
+    (void)pid; (void)page_number;
+    ReplacementState *r = &mem_system->repl;
+    if (r->num_resident == 0) {
+        return -1;
+    }
     
-    // Liberar procesos
-    for (int i = 0; i < MAX_PROCESSES; i++) {
-        if (mem_system->processes[i]) {
-            free(mem_system->processes[i]->page_table);
-            free(mem_system->processes[i]);
+    // Como máximo dos vueltas: la primera limpia bits de referencia. Otros
+    // núcleos pueden volver a marcarlos mientras tanto; tras dos vueltas se
+    // toma el primer marco residente que encontró la manecilla.
+    int first = -1;
+    for (int step = 0; step < 2 * r->num_frames; step++) {
+        int frame_index = r->hand;
+        r->hand = (r->hand + 1) % r->num_frames;
+        if (!r->resident[frame_index]) continue;
+        if (first == -1) first = frame_index;
+        if (!__atomic_exchange_n(&r->referenced[frame_index], false, __ATOMIC_RELAXED)) {
+            return frame_index;
         }
     }
-    
-    // Liberar estructuras
-    free(mem_system->ram_frames);
-    free(mem_system->swap_frames);
-    free(mem_system->tlb);
-    free_fifo_queue(mem_system->fifo_queue);
-    free(mem_system->logs);
-    free(mem_system);
-    
-    printf("\n✓ Sistema liberado correctamente.\n");
+    r->hand = (first + 1) % r->num_frames;
+    return first;
 }
 
-// Agregar entrada al log
-void add_log(const char *message) {
-    if (mem_system->log_count >= MAX_LOG_ENTRIES) {
-        return; // Log lleno
-    }
+// OPT (Belady): la víctima es la página cuyo próximo uso está más lejos.
+// Cada carga/acceso inserta (próximo uso, marco) en un montículo máximo;
+// las entradas obsoletas se descartan al llegar a la cima: O(log n).
+static void opt_init(int num_frames) {
+    repl_init(num_frames);
+    ReplacementState *r = &mem_system->repl;
+    int n = num_frames > 0 ? num_frames : 1;
+    r->frame_key = (uint64_t*)malloc(n * sizeof(uint64_t));
+    r->heap_capacity = 2 * n + 64;
+    r->heap = (OptHeapEntry*)malloc(r->heap_capacity * sizeof(OptHeapEntry));
+}
+
+// Próximo uso de la página que ocupa un marco
+static uint64_t opt_frame_key(int frame_index) {
+    const OptOracle *oracle = mem_system->repl.oracle;
+    int pid = mem_system->ram_frames.pid[frame_index];
+    int page_number = mem_system->ram_frames.page_number[frame_index];
+    if (!oracle || pid < 1 || pid > MAX_PROCESSES) return OPT_NEVER;
     
-    LogEntry *entry = &mem_system->logs[mem_system->log_count++];
-    entry->timestamp = time(NULL);
-    strncpy(entry->message, message, sizeof(entry->message) - 1);
-    entry->message[sizeof(entry->message) - 1] = '\0';
+    int trace_pid = oracle->sim_to_trace[pid];
+    if (trace_pid < 1 || page_number >= oracle->num_pages[trace_pid]) return OPT_NEVER;
+    return oracle->next_pos[trace_pid][page_number];
 }
 
-// Buscar proceso por PID
-PCB* find_process(int pid) {
-    for (int i = 0; i < MAX_PROCESSES; i++) {
-        if (mem_system->processes[i] && mem_system->processes[i]->pid == pid) {
-            return mem_system->processes[i];
-        }
+static void opt_heap_push(uint64_t key, int frame_index) {
+    ReplacementState *r = &mem_system->repl;
+    int i = r->heap_size++;
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (r->heap[parent].key >= key) break;
+        r->heap[i] = r->heap[parent];
+        i = parent;
     }
-    return NULL;
+    r->heap[i].key = key;
+    r->heap[i].frame = frame_index;
 }
 
-// Buscar marco libre en RAM
-int find_free_ram_frame() {
-    for (int i = 0; i < NUM_RAM_FRAMES; i++) {
-        if (!mem_system->ram_frames[i].occupied) {
-            return i;
-        }
+static void opt_heap_pop(void) {
+    ReplacementState *r = &mem_system->repl;
+    OptHeapEntry last = r->heap[--r->heap_size];
+    int i = 0;
+    for (;;) {
+        int child = 2 * i + 1;
+        if (child >= r->heap_size) break;
+        if (child + 1 < r->heap_size && r->heap[child + 1].key > r->heap[child].key) child++;
+        if (r->heap[child].key <= last.key) break;
+        r->heap[i] = r->heap[child];
+        i = child;
     }
-    return -1; // No hay marcos libres
+    if (r->heap_size > 0) r->heap[i] = last;
 }
 
-// Buscar marco libre en Swap
-int find_free_swap_frame() {
-    for (int i = 0; i < NUM_SWAP_FRAMES; i++) {
-        if (!mem_system->swap_frames[i].occupied) {
-            return i;
+// Reconstruir el montículo solo con los marcos residentes
+static void opt_rebuild_heap(void) {
+    ReplacementState *r = &mem_system->repl;
+    r->heap_size = 0;
+    for (int i = 0; i < r->num_frames; i++) {
+        if (r->resident[i]) {
+            r->frame_key[i] = opt_frame_key(i);
+            opt_heap_push(r->frame_key[i], i);
         }
     }
-    return -1; // No hay marcos libres
 }
 
-// Seleccionar página víctima usando FIFO
-int select_victim_page_fifo() {
-    if (is_fifo_empty(mem_system->fifo_queue)) {
-        return -1;
+static void opt_on_access(int frame_index) {
+    ReplacementState *r = &mem_system->repl;
+    if (!r->resident[frame_index]) return;
+    
+    // Compactar si las entradas obsoletas dominan el montículo
+    if (r->heap_size >= r->heap_capacity) {
+        opt_rebuild_heap();
     }
-    int victim = dequeue_fifo(mem_system->fifo_queue);
-    return victim;
+    r->frame_key[frame_index] = opt_frame_key(frame_index);
+    opt_heap_push(r->frame_key[frame_index], frame_index);
 }
 
-// Intercambiar página de RAM a Swap (Swap Out)
-bool swap_out_page(int frame_index) {
-    if (frame_index < 0 || frame_index >= NUM_RAM_FRAMES) {
-        return false;
-    }
-    
-    Frame *ram_frame = &mem_system->ram_frames[frame_index];
-    if (!ram_frame->occupied) {
-        return false;
+static void opt_on_load(int frame_index) {
+    clock_on_load(frame_index);
+    opt_on_access(frame_index);
+}
+
+static int opt_choose_victim(int pid, int page_number) {
+    (void)pid; (void)page_number;
+    ReplacementState *r = &mem_system->repl;
+    while (r->heap_size > 0) {
+        OptHeapEntry top = r->heap[0];
+        if (r->resident[top.frame] && r->frame_key[top.frame] == top.key) {
+            return top.frame;
+        }
+        opt_heap_pop();
     }
-    
-    // Buscar proceso y página
-    PCB *process = find_process(ram_frame->pid);
-    if (!process) {
-        return false;
+    return -1;
+}
+
+// Conectar el oráculo de la traza y recalcular las claves de los marcos
+void opt_attach_oracle(const OptOracle *oracle) {
+    mem_system->repl.oracle = oracle;
+    if (mem_system->repl.heap) {
+        opt_rebuild_heap();
     }
+}
+
+// ARC: T1 guarda páginas vistas una vez y T2 las reutilizadas. Las páginas
+// expulsadas quedan como fantasmas en B1/B2; un fallo sobre un fantasma de B1
+// agranda el objetivo p de T1 y uno de B2 lo reduce. Un recorrido secuencial
+// solo pasa por T1 y no desplaza el conjunto caliente de T2.
+static void index_list_push(IndexList *list, int *prev, int *next, int index) {
+    prev[index] = list->tail;
+    next[index] = -1;
+    if (list->tail != -1) next[list->tail] = index;
+    else list->head = index;
+    list->tail = index;
+    list->size++;
+}
+
+static void index_list_remove(IndexList *list, int *prev, int *next, int index) {
+    int p = prev[index];
+    int n = next[index];
+    if (p != -1) next[p] = n;
+    else list->head = n;
+    if (n != -1) prev[n] = p;
+    else list->tail = p;
+    list->size--;
+}
+
+static void arc_init(int num_frames) {
+    repl_init(num_frames);
+    ArcState *arc = &mem_system->repl.arc;
+    int n = num_frames > 0 ? num_frames : 1;
+    int ghosts = 2 * n; // |T1| + |T2| + |B1| + |B2| <= 2c
     
-    int page_number = ram_frame->page_number;
-    PageTableEntry *page_entry = &process->page_table[page_number];
-    
-    // Buscar espacio en Swap
-    int swap_frame = find_free_swap_frame();
-    if (swap_frame == -1) {
-        char msg[256];
-        snprintf(msg, sizeof(msg), "ERROR: No hay espacio en Swap para el Proceso %d, Página %d", 
-                 ram_frame->pid, page_number);
-        add_log(msg);
-        return false;
+    arc->t1.head = arc->t1.tail = -1;
+    arc->t2.head = arc->t2.tail = -1;
+    arc->b1.head = arc->b1.tail = -1;
+    arc->b2.head = arc->b2.tail = -1;
+    arc->in_t2 = (bool*)calloc(n, sizeof(bool));
+    arc->ghost_key = (uint64_t*)malloc(ghosts * sizeof(uint64_t));
+    arc->ghost_prev = (int*)malloc(ghosts * sizeof(int));
+    arc->ghost_next = (int*)malloc(ghosts * sizeof(int));
+    arc->ghost_hnext = (int*)malloc(ghosts * sizeof(int));
+    arc->ghost_in_b2 = (bool*)calloc(ghosts, sizeof(bool));
+    for (int i = 0; i < ghosts; i++) {
+        arc->ghost_next[i] = i + 1 < ghosts ? i + 1 : -1;
     }
+    arc->free_ghost = 0;
     
-    // Mover página a Swap
-    mem_system->swap_frames[swap_frame].pid = ram_frame->pid;
-    mem_system->swap_frames[swap_frame].page_number = page_number;
-    mem_system->swap_frames[swap_frame].occupied = true;
-    mem_system->swap_frames[swap_frame].load_time = time(NULL);
+    uint64_t num_buckets = 1;
+    while (num_buckets < (uint64_t)ghosts) num_buckets <<= 1;
+    arc->buckets = (int*)malloc(num_buckets * sizeof(int));
+    for (uint64_t i = 0; i < num_buckets; i++) arc->buckets[i] = -1;
+    arc->bucket_mask = num_buckets - 1;
+    
+    arc->capacity = num_frames;
+    arc->p = 0;
+    arc->p_min = 0;
+    arc->p_max = 0;
+    arc->sample_interval = 1024;
+    arc->next_sample = 0;
+}
+
+static inline uint64_t arc_key(int pid, int page_number) {
+    return ((uint64_t)(uint32_t)pid << 32) | (uint32_t)page_number;
+}
+
+static inline uint64_t arc_bucket(uint64_t key) {
+    return ((key * 0x9E3779B97F4A7C15ULL) >> 32) & mem_system->repl.arc.bucket_mask;
+}
+
+// Buscar un fantasma por (pid, página); -1 si no está en B1 ni B2
+static int arc_ghost_find(uint64_t key) {
+    ArcState *arc = &mem_system->repl.arc;
+    for (int g = arc->buckets[arc_bucket(key)]; g != -1; g = arc->ghost_hnext[g]) {
+        if (arc->ghost_key[g] == key) return g;
+    }
+    return -1;
+}
+
+static void arc_ghost_remove(int g) {
+    ArcState *arc = &mem_system->repl.arc;
+    IndexList *list = arc->ghost_in_b2[g] ? &arc->b2 : &arc->b1;
+    index_list_remove(list, arc->ghost_prev, arc->ghost_next, g);
+    
+    int *link = &arc->buckets[arc_bucket(arc->ghost_key[g])];
+    while (*link != g) link = &arc->ghost_hnext[*link];
+    *link = arc->ghost_hnext[g];
+    
+    arc->ghost_next[g] = arc->free_ghost;
+    arc->free_ghost = g;
+}
+
+static void arc_ghost_insert(uint64_t key, bool in_b2) {
+    ArcState *arc = &mem_system->repl.arc;
+    if (arc->free_ghost == -1) {
+        arc_ghost_remove(arc->b1.size > 0 ? arc->b1.head : arc->b2.head);
+    }
+    int g = arc->free_ghost;
+    arc->free_ghost = arc->ghost_next[g];
+    
+    arc->ghost_key[g] = key;
+    arc->ghost_in_b2[g] = in_b2;
+    index_list_push(in_b2 ? &arc->b2 : &arc->b1, arc->ghost_prev, arc->ghost_next, g);
+    
+    uint64_t bucket = arc_bucket(key);
+    arc->ghost_hnext[g] = arc->buckets[bucket];
+    arc->buckets[bucket] = g;
+}
+
+// Guardar p cada sample_interval ticks; al llenarse el historial se
+// descarta una muestra de cada dos y se duplica el intervalo
+static void arc_sample(void) {
+    ArcState *arc = &mem_system->repl.arc;
+    if (sim_tick() < arc->next_sample) return;
+    
+    if (arc->history_count == ARC_HISTORY) {
+        for (int i = 0; i < ARC_HISTORY / 2; i++) {
+            arc->history[i] = arc->history[2 * i + 1];
+        }
+        arc->history_count = ARC_HISTORY / 2;
+        arc->sample_interval *= 2;
+    }
+    arc->history[arc->history_count].tick = sim_tick();
+    arc->history[arc->history_count].p = arc->p;
+    arc->history_count++;
+    arc->next_sample = sim_tick() + arc->sample_interval;
+}
+
+// Adaptar p ante un fallo sobre el fantasma g
+static void arc_adapt(int g) {
+    ArcState *arc = &mem_system->repl.arc;
+    if (!arc->ghost_in_b2[g]) {
+        int delta = arc->b2.size > arc->b1.size ? arc->b2.size / arc->b1.size : 1;
+        arc->p = arc->p + delta < arc->capacity ? arc->p + delta : arc->capacity;
+        arc->b1_hits++;
+    } else {
+        int delta = arc->b1.size > arc->b2.size ? arc->b1.size / arc->b2.size : 1;
+        arc->p = arc->p - delta > 0 ? arc->p - delta : 0;
+        arc->b2_hits++;
+    }
+    if (arc->p < arc->p_min) arc->p_min = arc->p;
+    if (arc->p > arc->p_max) arc->p_max = arc->p;
+}
+
+static void arc_on_load(int frame_index) {
+    ReplacementState *r = &mem_system->repl;
+    ArcState *arc = &r->arc;
+    uint64_t key = arc_key(mem_system->ram_frames.pid[frame_index], 
+                           mem_system->ram_frames.page_number[frame_index]);
+    
+    if (r->resident[frame_index]) {
+        index_list_remove(arc->in_t2[frame_index] ? &arc->t2 : &arc->t1, 
+                          r->prev, r->next, frame_index);
+        r->num_resident--;
+    }
+    
+    int g = arc_ghost_find(key);
+    if (g != -1) {
+        // Fallo sobre un fantasma: la página vuelve directamente a T2
+        if (!(arc->pending && arc->pending_key == key)) arc_adapt(g);
+        arc_ghost_remove(g);
+        arc->in_t2[frame_index] = true;
+        index_list_push(&arc->t2, r->prev, r->next, frame_index);
+    } else {
+        // Página nueva: mantener |T1| + |B1| <= c y el total <= 2c
+        if (arc->t1.size + arc->b1.size >= arc->capacity && arc->b1.size > 0) {
+            arc_ghost_remove(arc->b1.head);
+        } else if (arc->t1.size + arc->t2.size + arc->b1.size + arc->b2.size >= 2 * arc->capacity &&
+                   arc->b2.size > 0) {
+            arc_ghost_remove(arc->b2.head);
+        }
+        arc->in_t2[frame_index] = false;
+        index_list_push(&arc->t1, r->prev, r->next, frame_index);
+    }
+    arc->pending = false;
+    r->resident[frame_index] = true;
+    r->num_resident++;
+    arc_sample();
+}
+
+// Un acceso repetido promueve la página a T2 (el acceso que provocó la
+// carga ocurre en el mismo tick y no cuenta)
+static void arc_on_access(int frame_index) {
+    ReplacementState *r = &mem_system->repl;
+    ArcState *arc = &r->arc;
+    if (!r->resident[frame_index] || 
+        mem_system->ram_frames.load_time[frame_index] == sim_tick()) {
+        return;
+    }
+    index_list_remove(arc->in_t2[frame_index] ? &arc->t2 : &arc->t1, 
+                      r->prev, r->next, frame_index);
+    arc->in_t2[frame_index] = true;
+    index_list_push(&arc->t2, r->prev, r->next, frame_index);
+}
+
+static void arc_on_free(int frame_index) {
+    ReplacementState *r = &mem_system->repl;
+    if (!r->resident[frame_index]) return;
+    index_list_remove(r->arc.in_t2[frame_index] ? &r->arc.t2 : &r->arc.t1, 
+                      r->prev, r->next, frame_index);
+    r->resident[frame_index] = false;
+    r->num_resident--;
+}
+
+// La página expulsada pasa al fantasma de su lista
+static void arc_on_evict(int frame_index) {
+    ReplacementState *r = &mem_system->repl;
+    const FrameTable *frames = &mem_system->ram_frames;
+    if (frames->pid[frame_index] == -1) return;
+    
+    uint64_t key = arc_key(frames->pid[frame_index], frames->page_number[frame_index]);
+    if (arc_ghost_find(key) == -1) {
+        arc_ghost_insert(key, r->arc.in_t2[frame_index]);
+    }
+}
+
+// REPLACE de ARC: se expulsa de T1 si supera el objetivo p
+static int arc_choose_victim(int pid, int page_number) {
+    ArcState *arc = &mem_system->repl.arc;
+    uint64_t key = arc_key(pid, page_number);
+    
+    // p se adapta antes de elegir, como en el algoritmo original
+    int g = arc_ghost_find(key);
+    if (g != -1 && !(arc->pending && arc->pending_key == key)) {
+        arc_adapt(g);
+        arc->pending = true;
+        arc->pending_key = key;
+    }
+    
+    bool in_b2 = g != -1 && arc->ghost_in_b2[g];
+    if (arc->t1.size > 0 && 
+        (arc->t1.size > arc->p || (in_b2 && arc->t1.size == arc->p) || arc->t2.size == 0)) {
+        return arc->t1.head;
+    }
+    return arc->t2.head;
+}
+
+// Tabla de políticas disponibles
+static const ReplacementPolicy POLICIES[] = {
+    { "FIFO", repl_init, repl_destroy, list_on_load, NULL,
+      list_on_free, NULL, list_head_victim, false },
+    { "LRU", repl_init, repl_destroy, list_on_load, lru_on_access,
+      list_on_free, NULL, list_head_victim, true },
+    { "CLOCK", repl_init, repl_destroy, clock_on_load, reference_on_access,
+      clock_on_free, NULL, clock_choose_victim, false },
+    { "SECOND_CHANCE", repl_init, repl_destroy, list_on_load, reference_on_access,
+      list_on_free, NULL, second_chance_choose_victim, false },
+    { "ARC", arc_init, repl_destroy, arc_on_load, arc_on_access,
+      arc_on_free, arc_on_evict, arc_choose_victim, true },
+    { "OPT", opt_init, repl_destroy, opt_on_load, opt_on_access,
+      clock_on_free, NULL, opt_choose_victim, true },
+};
+
+// Buscar política por nombre (NULL si no existe)
+const ReplacementPolicy* find_policy(const char *name) {
+    for (size_t i = 0; i < sizeof(POLICIES) / sizeof(POLICIES[0]); i++) {
+        if (strcmp(POLICIES[i].name, name) == 0) {
+            return &POLICIES[i];
+        }
+    }
+    return NULL;
+}
+
+// Inicializar TLB
+void init_tlb() {
+    // Normalizar geometría: TLB_SIZE = TLB_SETS * TLB_WAYS
+    if (TLB_SIZE < 1) TLB_SIZE = 1;
+    if (TLB_WAYS < 1 || TLB_WAYS > TLB_SIZE) TLB_WAYS = TLB_SIZE;
+    TLB_SETS = TLB_SIZE / TLB_WAYS;
+    if (TLB_SIZE % TLB_WAYS != 0) {
+        printf("⚠️  TLB_SIZE (%d) no es múltiplo de TLB_WAYS (%d). La TLB tendrá %d entradas.\n", 
+               TLB_SIZE, TLB_WAYS, TLB_SETS * TLB_WAYS);
+    }
+    TLB_SIZE = TLB_SETS * TLB_WAYS;
+    
+    // Una TLB por núcleo
+    mem_system->num_cores = CORES > 1 ? CORES : 1;
+    mem_system->cores = (Core*)calloc(mem_system->num_cores, sizeof(Core));
+    for (int c = 0; c < mem_system->num_cores; c++) {
+        Core *core = &mem_system->cores[c];
+        core->tlb = (TLBEntry*)malloc(TLB_SIZE * sizeof(TLBEntry));
+        for (int i = 0; i < TLB_SIZE; i++) {
+            core->tlb[i].valid = false;
+            core->tlb[i].huge = false;
+            core->tlb[i].pid = -1;
+            core->tlb[i].page_number = -1;
+            core->tlb[i].frame_number = -1;
+            core->tlb[i].last_access = 0;
+        }
+    }
+}
+
+// Núcleo del hilo actual. Los hilos que no son núcleos no consultan la
+// TLB; si llegan aquí usan el núcleo 0.
+static inline Core *this_core(void) {
+    return &mem_system->cores[current_core >= 0 ? current_core : 0];
+}
+
+// Cerrar/abrir la TLB de un núcleo (solo hace falta con varios hilos)
+static inline void core_lock(Core *core) {
+#ifndef _WIN32
+    if (mem_system->locking) pthread_mutex_lock(&core->tlb_lock);
+#else
+    (void)core;
+#endif
+}
+
+static inline void core_unlock(Core *core) {
+#ifndef _WIN32
+    if (mem_system->locking) pthread_mutex_unlock(&core->tlb_lock);
+#else
+    (void)core;
+#endif
+}
+
+// Primera entrada del conjunto que corresponde a (pid, página)
+static inline TLBEntry* tlb_set(Core *core, int pid, int page_number) {
+    uint64_t key = ((uint64_t)(uint32_t)pid << 32) | (uint32_t)page_number;
+    key *= 0x9E3779B97F4A7C15ULL; // Hash multiplicativo (Fibonacci)
+    int set = (int)((key >> 32) % (uint64_t)TLB_SETS);
+    return &core->tlb[set * TLB_WAYS];
+}
+
+// Vía del conjunto que traduce (pid, página) con el tamaño indicado
+static inline TLBEntry* tlb_find(TLBEntry *set, int pid, int page_number, bool huge) {
+    for (int way = 0; way < TLB_WAYS; way++) {
+        if (set[way].valid && 
+            set[way].pid == pid && 
+            set[way].page_number == page_number &&
+            set[way].huge == huge) {
+            return &set[way];
+        }
+    }
+    return NULL;
+}
+
+// Buscar en la TLB del núcleo actual (solo se recorren las vías de un
+// conjunto); el llamador tiene la TLB cerrada. Con páginas grandes también
+// se busca la entrada de la página grande que contiene a la página, en el
+// conjunto de su primera página, y el marco sale de su desplazamiento.
+int tlb_lookup(int pid, int page_number) {
+    Core *core = this_core();
+    TLBEntry *entry = tlb_find(tlb_set(core, pid, page_number), pid, page_number, false);
+    int offset = 0;
+    if (!entry && HUGE_PAGE_ORDER > 0) {
+        int mask = (1 << HUGE_PAGE_ORDER) - 1;
+        int base = page_number & ~mask;
+        entry = tlb_find(tlb_set(core, pid, base), pid, base, true);
+        offset = page_number & mask;
+        if (entry) core->tlb_huge_hits++;
+    }
+    if (entry) {
+        entry->last_access = ++core->tlb_clock;
+        core->tlb_hits++;
+        return entry->frame_number + offset;
+    }
+    core->tlb_misses++;
+    return -1; // TLB miss
+}
+
+// Cargar una traducción en la TLB del núcleo actual
+static void tlb_insert(int pid, int page_number, int frame_number, bool huge) {
+    Core *core = this_core();
+    core_lock(core);
+    
+    // Dentro del conjunto: la misma traducción, una vía vacía o la menos usada
+    TLBEntry *set = tlb_set(core, pid, page_number);
+    TLBEntry *victim = &set[0];
+    
+    for (int way = 0; way < TLB_WAYS; way++) {
+        TLBEntry *entry = &set[way];
+        if (entry->valid && entry->pid == pid && entry->page_number == page_number &&
+            entry->huge == huge) {
+            victim = entry;
+            break;
+        }
+        if (!entry->valid) {
+            if (victim->valid) victim = entry;
+        } else if (victim->valid && entry->last_access < victim->last_access) {
+            victim = entry;
+        }
+    }
+    
+    // Actualizar entrada
+    victim->pid = pid;
+    victim->page_number = page_number;
+    victim->frame_number = frame_number;
+    victim->valid = true;
+    victim->huge = huge;
+    victim->last_access = ++core->tlb_clock;
+    core_unlock(core);
+}
+
+// Actualizar la TLB del núcleo actual
+void tlb_update(int pid, int page_number, int frame_number) {
+    tlb_insert(pid, page_number, frame_number, false);
+}
+
+// Una sola entrada para toda la página grande que contiene a page_number
+void tlb_update_huge(int pid, int page_number, int frame_number) {
+    int offset = page_number & ((1 << HUGE_PAGE_ORDER) - 1);
+    tlb_insert(pid, page_number - offset, frame_number - offset, true);
+}
+
+// Invalidar entradas de TLB de un proceso en todos los núcleos
+void tlb_invalidate(int pid) {
+    for (int c = 0; c < mem_system->num_cores; c++) {
+        Core *core = &mem_system->cores[c];
+        core_lock(core);
+        for (int i = 0; i < TLB_SIZE; i++) {
+            if (core->tlb[i].valid && core->tlb[i].pid == pid) {
+                core->tlb[i].valid = false;
+            }
+        }
+        core_unlock(core);
+    }
+}
+
+// Invalidar una traducción en todas las TLB (shootdown). Cada TLB de otro
+// núcleo que tenía la entrada cuenta como una IPI (desde kswapd, cualquier
+// TLB). Cerrar la TLB de otro núcleo espera a que termine su acierto en curso.
+static void tlb_shootdown(int pid, int page_number, bool huge) {
+    for (int c = 0; c < mem_system->num_cores; c++) {
+        Core *core = &mem_system->cores[c];
+        core_lock(core);
+        TLBEntry *entry = tlb_find(tlb_set(core, pid, page_number), pid, page_number, huge);
+        if (entry) {
+            entry->valid = false;
+            if (c != current_core) {
+                core->shootdowns++;
+                mem_system->total_tlb_ipis++;
+            }
+        }
+        core_unlock(core);
+    }
+    mem_system->total_tlb_shootdowns++;
+}
+
+// Invalidar la traducción de una sola página
+void tlb_invalidate_page(int pid, int page_number) {
+    tlb_shootdown(pid, page_number, false);
+}
+
+// Invalidar la entrada de la página grande que empieza en page_number
+void tlb_invalidate_huge(int pid, int page_number) {
+    tlb_shootdown(pid, page_number, true);
+}
+
+// Sumar los contadores de los núcleos en los totales del sistema
+void cores_fold_stats() {
+    mem_system->total_memory_accesses = 0;
+    mem_system->total_tlb_hits = 0;
+    mem_system->total_tlb_misses = 0;
+    mem_system->total_tlb_huge_hits = 0;
+    mem_system->arena_bytes_touched = 0;
+    for (int c = 0; c < mem_system->num_cores; c++) {
+        const Core *core = &mem_system->cores[c];
+        mem_system->total_memory_accesses += core->accesses;
+        mem_system->total_tlb_hits += core->tlb_hits;
+        mem_system->total_tlb_misses += core->tlb_misses;
+        mem_system->total_tlb_huge_hits += core->tlb_huge_hits;
+        mem_system->arena_bytes_touched += core->arena_bytes_touched;
+    }
+}
+
+// Reloj simulado total: fallos y recorridos (globales) más aciertos en TLB
+static unsigned long long sim_time_total(void) {
+    unsigned long long total = mem_system->sim_time_ns;
+    for (int c = 0; c < mem_system->num_cores; c++) {
+        total += mem_system->cores[c].sim_time_ns;
+    }
+    return total;
+}
+
+// Inicializar sistema de memoria
+void init_system() {
+    // Calcular número de marcos
+    NUM_RAM_FRAMES = RAM_SIZE / PAGE_SIZE;
+    NUM_SWAP_FRAMES = SWAP_SIZE / PAGE_SIZE;
+    if (PAGE_TABLE_LEVELS < 1) PAGE_TABLE_LEVELS = 1;
+    if (PAGE_TABLE_LEVELS > 4) PAGE_TABLE_LEVELS = 4;
+
+    // La entrada de la tabla de páginas guarda marco y ranura en PTE_INDEX_BITS
+    if (NUM_RAM_FRAMES > PTE_INDEX_MAX || NUM_SWAP_FRAMES > PTE_INDEX_MAX) {
+        printf("⚠️  Más de %d marcos de RAM o de Swap. Se usan solo los primeros %d.\n",
+               PTE_INDEX_MAX, PTE_INDEX_MAX);
+        if (NUM_RAM_FRAMES > PTE_INDEX_MAX) NUM_RAM_FRAMES = PTE_INDEX_MAX;
+        if (NUM_SWAP_FRAMES > PTE_INDEX_MAX) NUM_SWAP_FRAMES = PTE_INDEX_MAX;
+    }
+
+    if (!quiet_mode) {
+        printf("\n╔════════════════════════════════════════════════════════════╗\n");
+        printf("║     INICIALIZANDO SIMULADOR DE GESTOR DE MEMORIA           ║\n");
+        printf("╚════════════════════════════════════════════════════════════╝\n\n");
+    }
+    
+    // Crear estructura del sistema
+    mem_system = (MemorySystem*)malloc(sizeof(MemorySystem));
+    mem_system->locking = false;
+    mem_system->kswapd_running = false;
+    
+    // Inicializar marcos de RAM
+    frame_table_init(&mem_system->ram_frames, NUM_RAM_FRAMES);
+    bitmap_init(&mem_system->ram_free, NUM_RAM_FRAMES);
+    
+    // Reservar la arena de RAM si está configurada
+    mem_system->arena = NULL;
+    if (RAM_ARENA && !arena_open()) {
+        printf("⚠️  Se continúa sin arena de RAM (solo metadatos).\n");
+    }
+    
+    // Inicializar marcos de Swap
+    frame_table_init(&mem_system->swap_frames, NUM_SWAP_FRAMES);
+    bitmap_init(&mem_system->swap_free, NUM_SWAP_FRAMES);
+    
+    // Inicializar caché de swap (vacía)
+    mem_system->swap_cache.head = -1;
+    mem_system->swap_cache.tail = -1;
+    mem_system->swap_cache.size = 0;
+    mem_system->swap_cache_prev = (int*)malloc(NUM_SWAP_FRAMES * sizeof(int));
+    mem_system->swap_cache_next = (int*)malloc(NUM_SWAP_FRAMES * sizeof(int));
+    mem_system->swap_cached = (bool*)calloc(NUM_SWAP_FRAMES, sizeof(bool));
+    
+    // Reclamación por lotes: como mucho una víctima por marco de RAM
+    mem_system->reclaim_batch = (int*)malloc(NUM_RAM_FRAMES * sizeof(int));
+    mem_system->swap_last_slot = -1;
+    mem_system->swap_last_write = -1;
+    
+    // Abrir el archivo de swap si está configurado
+    memset(&mem_system->swap_dev, 0, sizeof(mem_system->swap_dev));
+    mem_system->swap_dev.fd = -1;
+    mem_system->swap_dev.backend = SWAP_BACKEND_SYNC;
+    if (SWAP_FILE[0] != '\0' && !swap_device_open()) {
+        printf("⚠️  Se continúa sin archivo de swap (solo metadatos).\n");
+    }
+    
+    // Inicializar procesos
+    mem_system->num_processes = 0;
+    for (int i = 0; i < MAX_PROCESSES; i++) {
+        mem_system->processes[i] = NULL;
+    }
+    
+    // Inicializar TLB
+    init_tlb();
+    
+    // Inicializar política de reemplazo
+    mem_system->policy = find_policy(REPLACEMENT);
+    if (!mem_system->policy) {
+        printf("⚠️  Política de reemplazo '%s' desconocida. Usando FIFO.\n", REPLACEMENT);
+        mem_system->policy = find_policy("FIFO");
+    }
+    mem_system->policy->init(NUM_RAM_FRAMES);
+    
+    // Páginas grandes: 2^k marcos que quepan en la RAM, con el asignador buddy
+    // llevando los bloques contiguos. OPT solo conoce páginas base.
+    HUGE_PAGE_ORDER = 0;
+    memset(&mem_system->buddy, 0, sizeof(mem_system->buddy));
+    if (HUGE_PAGE_SIZE > 0) {
+        int frames = HUGE_PAGE_SIZE / PAGE_SIZE;
+        int order = 0;
+        while (order < BUDDY_MAX_ORDER && (1 << order) < frames) order++;
+        if (HUGE_PAGE_SIZE % PAGE_SIZE != 0 || frames < 2 || (1 << order) != frames ||
+            frames > NUM_RAM_FRAMES) {
+            printf("⚠️  HUGE_PAGE_SIZE debe ser PAGE_SIZE por una potencia de dos (2 a %d marcos). "
+                   "Se usan solo páginas base.\n", NUM_RAM_FRAMES);
+        } else if (strcmp(mem_system->policy->name, "OPT") == 0) {
+            printf("⚠️  OPT no admite páginas grandes. Se usan solo páginas base.\n");
+        } else if (buddy_init(&mem_system->buddy, NUM_RAM_FRAMES, order)) {
+            HUGE_PAGE_ORDER = order;
+        }
+    }
+    
+    // Inicializar estadísticas
+    mem_system->total_page_faults = 0;
+    mem_system->total_swap_reads = 0;
+    mem_system->total_swap_writes = 0;
+    mem_system->total_clean_evictions = 0;
+    mem_system->total_swap_cache_hits = 0;
+    mem_system->total_swap_cache_misses = 0;
+    mem_system->total_swap_cache_reclaims = 0;
+    mem_system->total_reclaim_passes = 0;
+    mem_system->total_reclaimed = 0;
+    mem_system->total_direct_reclaims = 0;
+    mem_system->total_kswapd_wakeups = 0;
+    mem_system->total_kswapd_reclaims = 0;
+    mem_system->total_kswapd_reclaimed = 0;
+    mem_system->kswapd_ns = 0;
+    mem_system->total_write_clusters = 0;
+    mem_system->total_swap_seeks = 0;
+    mem_system->total_readahead_batches = 0;
+    mem_system->total_prefetched = 0;
+    mem_system->total_prefetch_hits = 0;
+    mem_system->total_prefetch_wasted = 0;
+    mem_system->total_tlb_hits = 0;
+    mem_system->total_tlb_misses = 0;
+    mem_system->total_tlb_shootdowns = 0;
+    mem_system->total_tlb_ipis = 0;
+    mem_system->lock_acquired = 0;
+    mem_system->lock_contended = 0;
+    mem_system->total_memory_accesses = 0;
+    mem_system->total_page_walks = 0;
+    mem_system->total_walk_levels = 0;
+    mem_system->total_zero_fills = 0;
+    mem_system->page_table_bytes = 0;
+    mem_system->page_table_peak = 0;
+    mem_system->total_huge_pages = 0;
+    mem_system->total_huge_fallbacks = 0;
+    mem_system->total_huge_evictions = 0;
+    mem_system->huge_resident = 0;
+    mem_system->total_tlb_huge_hits = 0;
+    mem_system->tick = 0;
+    mem_system->sim_time_ns = 0;
+    mem_system->start_time = time(NULL);
+    
+    // Inicializar el registro de eventos
+    log_start();
+    
+    if (!quiet_mode) {
+        printf("✓ Memoria RAM inicializada: %d KB (%d marcos de %d KB)\n", 
+               RAM_SIZE, NUM_RAM_FRAMES, PAGE_SIZE);
+        printf("✓ Área de Swap inicializada: %d KB (%d marcos de %d KB)\n", 
+               SWAP_SIZE, NUM_SWAP_FRAMES, PAGE_SIZE);
+        printf("✓ TLB inicializada: %d entradas (%d conjuntos de %d vías)\n", 
+               TLB_SIZE, TLB_SETS, TLB_WAYS);
+        printf("✓ Algoritmo de reemplazo: %s\n", mem_system->policy->name);
+        if (PAGE_TABLE_LEVELS > 1) {
+            printf("✓ Tabla de páginas: %d niveles (las páginas se crean al primer acceso)\n", 
+                   PAGE_TABLE_LEVELS);
+        }
+        if (HUGE_PAGE_ORDER > 0) {
+            printf("✓ Páginas grandes: %d KB (%d marcos, asignador buddy)\n", 
+                   HUGE_PAGE_SIZE, 1 << HUGE_PAGE_ORDER);
+        }
+        if (mem_system->arena) {
+            printf("✓ Arena de RAM: %zu KB (%s)\n", mem_system->arena_size / 1024, 
+                   mem_system->arena_pages);
+        }
+        if (mem_system->swap_dev.fd != -1) {
+            printf("✓ Archivo de swap: %s (%s, E/S %s)\n", SWAP_FILE, 
+                   mem_system->swap_dev.direct ? "O_DIRECT" : "con caché del SO",
+                   swap_io_backend_name(mem_system->swap_dev.backend));
+        }
+    }
+    
+    // Los hilos auxiliares copian la configuración ya normalizada
+    config_save(&mem_system->config);
+    
+    // Arrancar kswapd con el sistema ya completo
+    locking_start();
+    kswapd_start();
+    if (!quiet_mode && mem_system->kswapd_running) {
+        printf("✓ kswapd: marcas de %d / %d marcos libres\n", 
+               mem_system->watermark_low, mem_system->watermark_high);
+    }
+    
+    LOG_INFO(EVENT_SYSTEM_INIT);
+}
+
+// Liberar sistema
+void free_system() {
+    if (!mem_system) return;
+    
+    // kswapd no debe tocar nada de lo que se libera a continuación
+    kswapd_stop();
+    locking_stop();
+    
+    // Liberar procesos
+    for (int i = 0; i < MAX_PROCESSES; i++) {
+        if (mem_system->processes[i]) {
+            page_table_destroy(mem_system->processes[i]);
+            free(mem_system->processes[i]);
+        }
+    }
+    
+    // Terminar la E/S pendiente antes de liberar los mapas de bits
+    swap_device_close();
+    
+    // Liberar estructuras
+    arena_close();
+    frame_table_destroy(&mem_system->ram_frames);
+    frame_table_destroy(&mem_system->swap_frames);
+    bitmap_destroy(&mem_system->ram_free);
+    bitmap_destroy(&mem_system->swap_free);
+    buddy_destroy(&mem_system->buddy);
+    free(mem_system->swap_cache_prev);
+    free(mem_system->swap_cache_next);
+    free(mem_system->swap_cached);
+    free(mem_system->reclaim_batch);
+    for (int c = 0; c < mem_system->num_cores; c++) {
+        free(mem_system->cores[c].tlb);
+    }
+    free(mem_system->cores);
+    mem_system->policy->destroy();
+    log_stop();
+    free(mem_system);
+    mem_system = NULL;
+    
+    if (!quiet_mode) {
+        printf("\n✓ Sistema liberado correctamente.\n");
+    }
+}
+
+// ==================== REGISTRO DE EVENTOS ====================
+// Cada evento es un LogEvent binario que se publica en un anillo sin
+// cerrojos (cola acotada de Vyukov): el productor reserva una posición con
+// un CAS sobre head, copia el evento y lo publica con la secuencia de la
+// posición. Con el anillo lleno el evento se descarta y se cuenta. Un hilo
+// vacía el anillo al archivo de eventos (LOG_FILE o, en el modo interactivo,
+// uno temporal); sin archivo el anillo conserva los primeros LOG_RING_SIZE
+// eventos. El texto solo se genera al mostrar o guardar el registro.
+// Cada tipo de evento tiene una severidad y una categoría (EVENT_CLASS): las
+// llamadas LOG_ERROR/INFO/DEBUG/TRACE por encima de LOG_COMPILE_LEVEL no se
+// compilan y el resto solo publican si su bit está en LOG_EVENT_MASK.
+
+static inline void events_lock(EventLog *events) {
+#ifndef _WIN32
+    pthread_mutex_lock(&events->lock);
+#else
+    (void)events;
+#endif
+}
+
+static inline void events_unlock(EventLog *events) {
+#ifndef _WIN32
+    pthread_mutex_unlock(&events->lock);
+#else
+    (void)events;
+#endif
+}
+
+// Pasar al archivo los eventos publicados (un solo consumidor: el llamador
+// tiene el cerrojo del registro o es el único hilo). Devuelve los vaciados.
+static uint64_t events_drain(EventLog *events) {
+    LogEvent batch[64];
+    uint64_t drained = 0;
+    fseek(events->file, 0, SEEK_END);
+    for (;;) {
+        size_t count = 0;
+        while (count < 64) {
+            LogSlot *slot = &events->slots[events->tail & events->mask];
+            if (__atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE) != events->tail + 1) break;
+            batch[count++] = slot->event;
+            __atomic_store_n(&slot->sequence, events->tail + events->mask + 1, __ATOMIC_RELEASE);
+            events->tail++;
+        }
+        if (count == 0) break;
+        
+        size_t written = fwrite(batch, sizeof(LogEvent), count, events->file);
+        events->stored += written;
+        if (written < count) {
+            __atomic_fetch_add(&events->overflow, count - written, __ATOMIC_RELAXED);
+        }
+        drained += count;
+    }
+    return drained;
+}
+
+#ifndef _WIN32
+// Hilo de vaciado: vacía el anillo cuando un productor lo despierta (cada
+// medio anillo) o cada 10 ms
+static void *events_main(void *arg) {
+    EventLog *events = (EventLog*)arg;
+    pthread_mutex_lock(&events->lock);
+    while (!events->stopping) {
+        if (events_drain(events) > 0) continue;
+        
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_nsec += 10 * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+        pthread_cond_timedwait(&events->wait, &events->lock, &deadline);
+    }
+    pthread_mutex_unlock(&events->lock);
+    return NULL;
+}
+#endif
+
+static const char *LOG_LEVEL_NAMES[] = { "OFF", "ERROR", "INFO", "DEBUG", "TRACE" };
+static const char *LOG_CATEGORY_NAMES[] = { "SISTEMA", "PROCESOS", "ACCESOS", "SWAP", "MEMORIA" };
+
+// Severidad por nombre (-1 = desconocida)
+static int log_level_parse(const char *name) {
+    for (int level = LOG_LEVEL_OFF; level <= LOG_LEVEL_TRACE; level++) {
+        if (strcmp(name, LOG_LEVEL_NAMES[level]) == 0) return level;
+    }
+    return -1;
+}
+
+// Calcular LOG_EVENT_MASK a partir de LOG_LEVEL y LOG_CATEGORIES. La
+// severidad efectiva no supera LOG_COMPILE_LEVEL.
+static void log_configure() {
+    int level = log_level_parse(LOG_LEVEL);
+    if (level < 0) {
+        printf("⚠️  LOG_LEVEL '%s' desconocido. Se usará TRACE.\n", LOG_LEVEL);
+        level = LOG_LEVEL_TRACE;
+        strcpy(LOG_LEVEL, LOG_LEVEL_NAMES[level]);
+    }
+    if (level > LOG_COMPILE_LEVEL) level = LOG_COMPILE_LEVEL;
+    
+    int categories = 0;
+    char list[MAX_LINE_LENGTH];
+    strcpy(list, LOG_CATEGORIES);
+    for (char *token = strtok(list, ", \t"); token; token = strtok(NULL, ", \t")) {
+        if (strcmp(token, "TODAS") == 0) {
+            categories = LOG_CATEGORY_ALL;
+            continue;
+        }
+        int i = 0;
+        while (i < LOG_CATEGORY_COUNT && strcmp(token, LOG_CATEGORY_NAMES[i]) != 0) i++;
+        if (i < LOG_CATEGORY_COUNT) {
+            categories |= 1 << i;
+        } else {
+            printf("⚠️  Categoría de registro '%s' desconocida. Se ignora.\n", token);
+        }
+    }
+    
+    LOG_EVENT_MASK = 0;
+    for (int type = 0; type < EVENT_TYPE_COUNT; type++) {
+        if (EVENT_CLASS[type].level <= level && (EVENT_CLASS[type].category & categories)) {
+            LOG_EVENT_MASK |= 1u << type;
+        }
+    }
+}
+
+// Crear el anillo, abrir el archivo de eventos y arrancar el hilo de vaciado
+void log_start() {
+    EventLog *events = &mem_system->events;
+    log_configure();
+    
+    int size = 64;
+    while (size < LOG_RING_SIZE && size < (1 << 24)) size <<= 1;
+    LOG_RING_SIZE = size;
+    
+    events->slots = (LogSlot*)malloc((size_t)size * sizeof(LogSlot));
+    for (int i = 0; i < size; i++) {
+        events->slots[i].sequence = (uint64_t)i;
+    }
+    events->mask = (uint64_t)size - 1;
+    events->head = 0;
+    events->tail = 0;
+    events->overflow = 0;
+    events->stored = 0;
+    events->file = NULL;
+    events->temporary = false;
+    events->running = false;
+    events->stopping = false;
+#ifndef _WIN32
+    pthread_mutex_init(&events->lock, NULL);
+#endif
+    
+    if (LOG_FILE[0] != '\0') {
+        events->file = fopen(LOG_FILE, "w+b");
+        if (!events->file) {
+            printf("⚠️  No se pudo crear el archivo de eventos '%s'. Los eventos quedan en el anillo.\n", 
+                   LOG_FILE);
+        }
+    } else if (!quiet_mode) {
+        events->file = tmpfile();
+        events->temporary = events->file != NULL;
+    }
+    if (!events->file) return;
+    
+    LogFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, LOG_MAGIC, sizeof(header.magic));
+    header.version = LOG_VERSION;
+    header.record_size = sizeof(LogEvent);
+    header.start_time = (int64_t)mem_system->start_time;
+    fwrite(&header, sizeof(header), 1, events->file);
+    
+#ifndef _WIN32
+    pthread_cond_init(&events->wait, NULL);
+    events->running = true;
+    if (pthread_create(&events->thread, NULL, events_main, events) != 0) {
+        // Sin hilo el anillo se vacía al leer el registro y al cerrarlo
+        events->running = false;
+        pthread_cond_destroy(&events->wait);
+    }
+#endif
+}
+
+// Detener el hilo de vaciado, vaciar lo que quede y cerrar el archivo
+void log_stop() {
+    EventLog *events = &mem_system->events;
+#ifndef _WIN32
+    if (events->running) {
+        pthread_mutex_lock(&events->lock);
+        events->stopping = true;
+        pthread_cond_signal(&events->wait);
+        pthread_mutex_unlock(&events->lock);
+        pthread_join(events->thread, NULL);
+        pthread_cond_destroy(&events->wait);
+        events->running = false;
+    }
+    pthread_mutex_destroy(&events->lock);
+#endif
+    if (events->file) {
+        events_drain(events);
+        fclose(events->file);
+        events->file = NULL;
+    }
+    free(events->slots);
+    events->slots = NULL;
+}
+
+// Registrar un evento desde cualquier hilo del simulador, sin cerrojos
+void log_event(const LogEvent *event) {
+    EventLog *events = &mem_system->events;
+    uint64_t pos = __atomic_load_n(&events->head, __ATOMIC_RELAXED);
+    LogSlot *slot;
+    for (;;) {
+        slot = &events->slots[pos & events->mask];
+        uint64_t sequence = __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE);
+        int64_t diff = (int64_t)(sequence - pos);
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&events->head, &pos, pos + 1, true, 
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) break;
+        } else if (diff < 0) {
+#ifdef _WIN32
+            // Sin hilo de vaciado, quien encuentra el anillo lleno lo vacía
+            if (events->file && events_drain(events) > 0) continue;
+#endif
+            // La posición guarda un evento sin vaciar: anillo lleno
+            __atomic_fetch_add(&events->overflow, 1, __ATOMIC_RELAXED);
+            return;
+        } else {
+            pos = __atomic_load_n(&events->head, __ATOMIC_RELAXED);
+        }
+    }
+    
+    slot->event = *event;
+    if (EVENT_CLASS[event->type].category == LOG_CATEGORY_PROCESS) {
+        // Los eventos de procesos se registran con el proceso en la tabla
+        const PCB *process = find_process(event->pid);
+        if (process) {
+            memcpy(slot->event.name, process->name, sizeof(slot->event.name) - 1); // Truncado
+        }
+    }
+    slot->event.tick = sim_tick();
+    slot->event.seconds = (uint32_t)difftime(time(NULL), mem_system->start_time);
+    __atomic_store_n(&slot->sequence, pos + 1, __ATOMIC_RELEASE);
+    
+#ifndef _WIN32
+    // Despertar al hilo de vaciado cada medio anillo
+    if (events->running && ((pos + 1) & (events->mask >> 1)) == 0) {
+        pthread_cond_signal(&events->wait);
+    }
+#endif
+}
+
+// Eventos que se pueden leer; con archivo, vacía antes el anillo (con el
+// cerrojo del registro tomado)
+static uint64_t events_readable(EventLog *events) {
+    if (events->file) {
+        events_drain(events);
+        return events->stored;
+    }
+    uint64_t head = __atomic_load_n(&events->head, __ATOMIC_ACQUIRE);
+    return head < events->mask + 1 ? head : events->mask + 1;
+}
+
+// Leer el evento index (con el cerrojo del registro tomado)
+static bool events_read(EventLog *events, uint64_t index, LogEvent *event) {
+    if (!events->file) {
+        const LogSlot *slot = &events->slots[index];
+        if (__atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE) != index + 1) return false;
+        *event = slot->event;
+        return true;
+    }
+    long offset = (long)(sizeof(LogFileHeader) + index * sizeof(LogEvent));
+    return fseek(events->file, offset, SEEK_SET) == 0 && 
+           fread(event, sizeof(LogEvent), 1, events->file) == 1;
+}
+
+// Texto de un evento
+static void log_format(const LogEvent *event, char *msg, size_t size) {
+    int first = event->page_number;
+    int last = event->page_number + event->count - 1;
+    switch ((LogEventType)event->type) {
+        case EVENT_SYSTEM_INIT:
+            snprintf(msg, size, "Sistema de memoria inicializado correctamente");
+            break;
+        case EVENT_PROCESS_CREATE:
+            snprintf(msg, size, "Proceso creado: PID=%d, Nombre='%s', Tamaño=%lld KB, Páginas=%d (RAM:%d, Swap:%d)", 
+                     event->pid, event->name, event->value, event->page_number, event->frame, event->swap_slot);
+            break;
+        case EVENT_PROCESS_CREATE_LAZY:
+            snprintf(msg, size, "Proceso creado: PID=%d, Nombre='%s', Tamaño=%lld KB, Páginas=%d (bajo demanda)", 
+                     event->pid, event->name, event->value, event->page_number);
+            break;
+        case EVENT_PROCESS_EXIT:
+            snprintf(msg, size, "Proceso terminado: PID=%d, Nombre='%s', Page Faults=%lld", 
+                     event->pid, event->name, event->value);
+            break;
+        case EVENT_TLB_HIT:
+            snprintf(msg, size, "Acceso a memoria: Proceso %d, Página %d - TLB HIT (Marco %d)", 
+                     event->pid, event->page_number, event->frame);
+            break;
+        case EVENT_PAGE_HIT:
+            snprintf(msg, size, "Acceso a memoria: Proceso %d, Página %d - En RAM (Marco %d)", 
+                     event->pid, event->page_number, event->frame);
+            break;
+        case EVENT_SWAP_IN:
+            snprintf(msg, size, "SWAP IN: Proceso %d, Página %d copiada de Swap[%d] a RAM[%d]", 
+                     event->pid, event->page_number, event->swap_slot, event->frame);
+            break;
+        case EVENT_READAHEAD:
+            snprintf(msg, size, "READAHEAD: Proceso %d, Página %d copiada de Swap[%d] a RAM[%d]", 
+                     event->pid, event->page_number, event->swap_slot, event->frame);
+            break;
+        case EVENT_ZERO_FILL:
+            snprintf(msg, size, "ZERO FILL: Proceso %d, Página %d en RAM[%d] (primer acceso)", 
+                     event->pid, event->page_number, event->frame);
+            break;
+        case EVENT_SWAP_OUT:
+            snprintf(msg, size, "SWAP OUT: Proceso %d, Página %d movida de RAM[%d] a Swap[%d]", 
+                     event->pid, event->page_number, event->frame, event->swap_slot);
+            break;
+        case EVENT_SWAP_OUT_CLEAN:
+            snprintf(msg, size, "SWAP OUT (limpia): Proceso %d, Página %d liberada de RAM[%d], copia vigente en Swap[%d]", 
+                     event->pid, event->page_number, event->frame, event->swap_slot);
+            break;
+        case EVENT_HUGE_MAP:
+            snprintf(msg, size, "PÁGINA GRANDE: Proceso %d, Páginas %d-%d en RAM[%d-%d] (%lld desde Swap)", 
+                     event->pid, first, last, event->frame, event->frame + event->count - 1, event->value);
+            break;
+        case EVENT_HUGE_SWAP_OUT:
+            snprintf(msg, size, "SWAP OUT (página grande): Proceso %d, Páginas %d-%d de RAM[%d-%d] a Swap (%lld escritas)", 
+                     event->pid, first, last, event->frame, event->frame + event->count - 1, event->value);
+            break;
+        case EVENT_SWAP_FULL:
+            snprintf(msg, size, "ERROR: No hay espacio en Swap para el Proceso %d, Página %d", 
+                     event->pid, event->page_number);
+            break;
+        case EVENT_HUGE_SWAP_FULL:
+            snprintf(msg, size, "ERROR: No hay espacio en Swap para la página grande del Proceso %d, Páginas %d-%d", 
+                     event->pid, first, last);
+            break;
+        case EVENT_NO_FRAME:
+            snprintf(msg, size, "ERROR: No se pudo liberar un marco de RAM para Proceso %d", event->pid);
+            break;
+        case EVENT_SWAP_READ_ERROR:
+            snprintf(msg, size, "ERROR: Fallo de lectura en Swap[%d] (Proceso %d, Página %d)", 
+                     event->swap_slot, event->pid, event->page_number);
+            break;
+        case EVENT_SWAP_WRITE_ERROR:
+            snprintf(msg, size, "ERROR: Fallo de escritura en Swap[%d] (Proceso %d, Página %d)", 
+                     event->swap_slot, event->pid, event->page_number);
+            break;
+        case EVENT_HUGE_READ_ERROR:
+            snprintf(msg, size, "ERROR: No se pudo traer la Página %d del Proceso %d a una página grande", 
+                     event->page_number, event->pid);
+            break;
+        case EVENT_HUGE_WRITE_ERROR:
+            snprintf(msg, size, "ERROR: Fallo de escritura en Swap (Proceso %d, Página %d de una página grande)", 
+                     event->pid, event->page_number);
+            break;
+        case EVENT_SWAP_ASYNC_ERROR:
+            snprintf(msg, size, "ERROR: Fallo de %s asíncrona en Swap[%d] (Proceso %d, Página %d)", 
+                     event->value ? "escritura" : "lectura", event->swap_slot, event->pid, event->page_number);
+            break;
+        default:
+            snprintf(msg, size, "Evento desconocido (%u)", event->type);
+            break;
+    }
+}
+
+// Buscar proceso por PID
+PCB* find_process(int pid) {
+    for (int i = 0; i < MAX_PROCESSES; i++) {
+        if (mem_system->processes[i] && mem_system->processes[i]->pid == pid) {
+            return mem_system->processes[i];
+        }
+    }
+    return NULL;
+}
+
+// ==================== ASIGNADOR BUDDY ====================
+// Con HUGE_PAGE_SIZE > 0 los marcos libres de RAM se llevan además en un
+// asignador buddy hasta el orden de una página grande. Los marcos sueltos se
+// toman del bloque libre más pequeño para no partir los grandes sin
+// necesidad; una página grande necesita un bloque entero de su orden.
+
+static void buddy_push(BuddyAllocator *buddy, int frame_index, int order) {
+    buddy->order[frame_index] = (int8_t)order;
+    index_list_push(&buddy->free[order], buddy->prev, buddy->next, frame_index);
+}
+
+static void buddy_unlink(BuddyAllocator *buddy, int frame_index) {
+    index_list_remove(&buddy->free[buddy->order[frame_index]], buddy->prev, buddy->next, 
+                      frame_index);
+    buddy->order[frame_index] = -1;
+}
+
+// Repartir los marcos en los bloques alineados más grandes posibles
+bool buddy_init(BuddyAllocator *buddy, int num_frames, int max_order) {
+    buddy->max_order = max_order;
+    buddy->order = (int8_t*)malloc(num_frames * sizeof(int8_t));
+    buddy->prev = (int*)malloc(num_frames * sizeof(int));
+    buddy->next = (int*)malloc(num_frames * sizeof(int));
+    if (!buddy->order || !buddy->prev || !buddy->next) {
+        buddy_destroy(buddy);
+        return false;
+    }
+    for (int order = 0; order <= BUDDY_MAX_ORDER; order++) {
+        buddy->free[order].head = -1;
+        buddy->free[order].tail = -1;
+        buddy->free[order].size = 0;
+    }
+    memset(buddy->order, -1, num_frames * sizeof(int8_t));
+    
+    for (int start = 0; start < num_frames; ) {
+        int order = max_order;
+        while (order > 0 && ((start & ((1 << order) - 1)) || start + (1 << order) > num_frames)) {
+            order--;
+        }
+        buddy_push(buddy, start, order);
+        start += 1 << order;
+    }
+    return true;
+}
+
+void buddy_destroy(BuddyAllocator *buddy) {
+    free(buddy->order);
+    free(buddy->prev);
+    free(buddy->next);
+    buddy->order = NULL;
+    buddy->prev = NULL;
+    buddy->next = NULL;
+    buddy->max_order = 0;
+}
+
+// Reservar un bloque de 2^order marcos partiendo uno mayor si hace falta;
+// devuelve su primer marco (-1 si no hay ninguno de ese orden o mayor)
+int buddy_alloc(BuddyAllocator *buddy, int order) {
+    int k = order;
+    while (k <= buddy->max_order && buddy->free[k].head == -1) k++;
+    if (k > buddy->max_order) {
+        return -1;
+    }
+    
+    int block = buddy->free[k].head;
+    buddy_unlink(buddy, block);
+    while (k > order) {
+        k--;
+        buddy_push(buddy, block + (1 << k), k);
+    }
+    return block;
+}
+
+// Marco libre que tomaría buddy_alloc(0), sin reservarlo
+int buddy_peek(const BuddyAllocator *buddy) {
+    for (int k = 0; k <= buddy->max_order; k++) {
+        if (buddy->free[k].head != -1) return buddy->free[k].head;
+    }
+    return -1;
+}
+
+// Reservar un marco concreto: se parte su bloque libre hasta dejarlo solo
+void buddy_take(BuddyAllocator *buddy, int frame_index) {
+    int order = 0;
+    int block = frame_index;
+    while (order <= buddy->max_order) {
+        block = frame_index & ~((1 << order) - 1);
+        if (buddy->order[block] == order) break;
+        order++;
+    }
+    if (order > buddy->max_order) {
+        return; // El marco no estaba libre
+    }
+    
+    buddy_unlink(buddy, block);
+    while (order > 0) {
+        order--;
+        int half = block + (1 << order);
+        if (frame_index >= half) {
+            buddy_push(buddy, block, order);
+            block = half;
+        } else {
+            buddy_push(buddy, half, order);
+        }
+    }
+}
+
+// Devolver un marco y unirlo con sus buddies libres
+void buddy_free(BuddyAllocator *buddy, int frame_index) {
+    int order = 0;
+    while (order < buddy->max_order) {
+        int mate = frame_index ^ (1 << order);
+        if (mate >= NUM_RAM_FRAMES || buddy->order[mate] != order) break;
+        buddy_unlink(buddy, mate);
+        if (mate < frame_index) frame_index = mate;
+        order++;
+    }
+    buddy_push(buddy, frame_index, order);
+}
+
+// Buscar marco libre en RAM
+int find_free_ram_frame() {
+    if (HUGE_PAGE_ORDER > 0) {
+        return buddy_peek(&mem_system->buddy);
+    }
+    return bitmap_find_first(&mem_system->ram_free); // -1 si no hay marcos libres
+}
+
+// Buscar marco libre en Swap
+int find_free_swap_frame() {
+    return bitmap_find_first(&mem_system->swap_free); // -1 si no hay marcos libres
+}
+
+// ==================== TABLA DE PÁGINAS ====================
+// Con PAGE_TABLE_LEVELS = 1 cada proceso tiene un arreglo denso de num_pages
+// entradas. Con 2 a 4 niveles la tabla es un árbol radix: los nodos
+// intermedios y las hojas (bloques de PT_LEVEL_ENTRIES entradas) se crean al
+// tocar por primera vez una página de su región, así que la memoria de la
+// tabla crece con lo usado y no con el tamaño virtual. Cada nivel leído en un
+// recorrido cuesta COST_PAGE_WALK.
+
+// Índice de page_number en el nodo de un nivel (0 = raíz)
+static inline int page_table_index(const PCB *process, int page_number, int level) {
+    int shift = PT_LEVEL_BITS * (PAGE_TABLE_LEVELS - 1 - level);
+    int mask = level == 0 ? (1 << process->pt_root_bits) - 1 : PT_LEVEL_ENTRIES - 1;
+    return (page_number >> shift) & mask;
+}
+
+// Sumar memoria a la tabla de un proceso
+static void page_table_account(PCB *process, size_t bytes) {
+    process->pt_bytes += bytes;
+    mem_system->page_table_bytes += bytes;
+    if (mem_system->page_table_bytes > mem_system->page_table_peak) {
+        mem_system->page_table_peak = mem_system->page_table_bytes;
+    }
+}
+
+// Crear la tabla de páginas vacía de un proceso (densa o solo la raíz)
+bool page_table_init(PCB *process) {
+    process->page_table = NULL;
+    process->pt_root = NULL;
+    process->pt_root_bits = 0;
+    process->pt_bytes = 0;
+    
+    if (PAGE_TABLE_LEVELS <= 1) {
+        // Entradas y metadatos fríos en un solo bloque: num_pages entradas
+        // seguidas de num_pages PageTableCold
+        size_t entry_bytes = sizeof(PageTableEntry) + sizeof(PageTableCold);
+        process->page_table = (PageTableEntry*)calloc(process->num_pages, entry_bytes);
+        if (!process->page_table) return false;
+        page_table_account(process, process->num_pages * entry_bytes);
+        for (int i = 0; i < process->num_pages; i++) {
+            process->page_table[i].frame_number = -1;
+            process->page_table[i].state = PAGE_FREE;
+            process->page_table[i].swap_position = -1;
+        }
+        return true;
+    }
+    
+    int bits = 1;
+    while (bits < 31 && (1L << bits) < process->num_pages) bits++;
+    process->pt_root_bits = bits - PT_LEVEL_BITS * (PAGE_TABLE_LEVELS - 1);
+    if (process->pt_root_bits < 1) process->pt_root_bits = 1;
+    
+    size_t root_bytes = ((size_t)1 << process->pt_root_bits) * sizeof(void*);
+    process->pt_root = (void**)calloc(1, root_bytes);
+    if (!process->pt_root) return false;
+    page_table_account(process, root_bytes);
+    return true;
+}
+
+// Recorrer la tabla hasta la entrada de page_number sin crear nada.
+// Retorna NULL si la región nunca se tocó; en *depth quedan los niveles
+// leídos (como en el hardware, el recorrido se detiene en el nodo ausente).
+PageTableEntry* page_table_walk(PCB *process, int page_number, int *depth) {
+    if (!process->pt_root) {
+        if (depth) *depth = 1;
+        return &process->page_table[page_number];
+    }
+    
+    void **node = process->pt_root;
+    for (int level = 0; level < PAGE_TABLE_LEVELS - 1; level++) {
+        if (depth) *depth = level + 1;
+        node = (void**)node[page_table_index(process, page_number, level)];
+        if (!node) return NULL;
+    }
+    if (depth) *depth = PAGE_TABLE_LEVELS;
+    return &((PageTableEntry*)node)[page_number & (PT_LEVEL_ENTRIES - 1)];
+}
+
+// Metadatos fríos de la entrada de page_number: están justo después del
+// arreglo de entradas (de la tabla densa o de la hoja del árbol)
+static inline PageTableCold* page_table_cold(const PCB *process, PageTableEntry *entry, int page_number) {
+    if (!process->pt_root) {
+        return (PageTableCold*)(process->page_table + process->num_pages) + page_number;
+    }
+    int slot = page_number & (PT_LEVEL_ENTRIES - 1);
+    return (PageTableCold*)(entry - slot + PT_LEVEL_ENTRIES) + slot;
+}
+
+// Entrada de una página, o NULL si su región no está materializada
+PageTableEntry* page_table_lookup(PCB *process, int page_number) {
+    return page_table_walk(process, page_number, NULL);
+}
+
+// Crear los nodos que falten en el camino de page_number
+static PageTableEntry* page_table_materialize(PCB *process, int page_number) {
+    if (!process->pt_root) {
+        return &process->page_table[page_number];
+    }
+    
+    void **node = process->pt_root;
+    for (int level = 0; level < PAGE_TABLE_LEVELS - 1; level++) {
+        void **slot = &node[page_table_index(process, page_number, level)];
+        if (!*slot) {
+            bool leaf = level == PAGE_TABLE_LEVELS - 2;
+            size_t bytes = PT_LEVEL_ENTRIES * (leaf ? sizeof(PageTableEntry) + sizeof(PageTableCold)
+                                                    : sizeof(void*));
+            *slot = calloc(1, bytes);
+            if (!*slot) return NULL;
+            page_table_account(process, bytes);
+            
+            if (leaf) {
+                // Las entradas de una hoja nueva empiezan libres; tras ellas
+                // van sus PT_LEVEL_ENTRIES metadatos fríos
+                PageTableEntry *entries = (PageTableEntry*)*slot;
+                for (int i = 0; i < PT_LEVEL_ENTRIES; i++) {
+                    entries[i].frame_number = -1;
+                    entries[i].state = PAGE_FREE;
+                    entries[i].swap_position = -1;
+                }
+            }
+        }
+        node = (void**)*slot;
+    }
+    return &((PageTableEntry*)node)[page_number & (PT_LEVEL_ENTRIES - 1)];
+}
+
+// Siguiente página en uso (en RAM o en Swap) desde page_number, saltando
+// las regiones sin materializar; -1 si no hay más
+int page_table_next(PCB *process, int page_number) {
+    long long page = page_number;
+    while (page < process->num_pages) {
+        int depth;
+        PageTableEntry *entry = page_table_walk(process, (int)page, &depth);
+        if (!entry) {
+            // El nodo ausente cubre toda una región alineada
+            int shift = PT_LEVEL_BITS * (PAGE_TABLE_LEVELS - depth);
+            page = ((page >> shift) + 1) << shift;
+            continue;
+        }
+        if (entry->state != PAGE_FREE) return (int)page;
+        page++;
+    }
+    return -1;
+}
+
+static void page_table_free_node(void **node, int level) {
+    if (level < PAGE_TABLE_LEVELS - 1) {
+        for (int i = 0; i < PT_LEVEL_ENTRIES; i++) {
+            if (node[i]) page_table_free_node((void**)node[i], level + 1);
+        }
+    }
+    free(node);
+}
+
+// Liberar la tabla de páginas (los marcos y ranuras se liberan antes)
+void page_table_destroy(PCB *process) {
+    mem_system->page_table_bytes -= process->pt_bytes;
+    process->pt_bytes = 0;
+    free(process->page_table);
+    process->page_table = NULL;
+    if (process->pt_root) {
+        for (int i = 0; i < (1 << process->pt_root_bits); i++) {
+            if (process->pt_root[i]) page_table_free_node((void**)process->pt_root[i], 1);
+        }
+        free(process->pt_root);
+        process->pt_root = NULL;
+    }
+}
+
+// ==================== ARENA DE RAM ====================
+// Con RAM_ARENA = 1 los marcos de RAM son porciones de PAGE_SIZE KB de una
+// única región mmap; cada acceso lee o escribe bytes en el desplazamiento
+// físico traducido, así el simulador genera tráfico real de memoria.
+
+// Reservar la arena (RAM_SIZE KB) con páginas grandes si se pidieron
+bool arena_open() {
+    mem_system->arena_size = (size_t)NUM_RAM_FRAMES * (size_t)PAGE_SIZE * 1024;
+    mem_system->arena_pages = "páginas normales";
+    mem_system->arena_bytes_touched = 0;
+    mem_system->arena_bytes_filled = 0;
+    
+#ifdef _WIN32
+    printf("❌ Error: La arena de RAM no está disponible en Windows.\n");
+    return false;
+#else
+    void *arena = MAP_FAILED;
+#ifdef MAP_HUGETLB
+    if (strcmp(RAM_ARENA_HUGEPAGES, "HUGETLB") == 0) {
+        arena = mmap(NULL, mem_system->arena_size, PROT_READ | PROT_WRITE, 
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (arena == MAP_FAILED) {
+            printf("⚠️  No hay páginas grandes reservadas (MAP_HUGETLB). Se usarán páginas normales.\n");
+        } else {
+            mem_system->arena_pages = "MAP_HUGETLB";
+        }
+    }
+#endif
+    if (arena == MAP_FAILED) {
+        arena = mmap(NULL, mem_system->arena_size, PROT_READ | PROT_WRITE, 
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    }
+    if (arena == MAP_FAILED) {
+        printf("❌ Error: No se pudo reservar la arena de RAM (%d KB).\n", RAM_SIZE);
+        return false;
+    }
+    
+#ifdef MADV_HUGEPAGE
+    if (strcmp(RAM_ARENA_HUGEPAGES, "MADVISE") == 0) {
+        if (madvise(arena, mem_system->arena_size, MADV_HUGEPAGE) == 0) {
+            mem_system->arena_pages = "MADV_HUGEPAGE";
+        } else {
+            printf("⚠️  madvise(MADV_HUGEPAGE) no está disponible. Se usarán páginas normales.\n");
+        }
+    }
+#endif
+    
+    mem_system->arena = (unsigned char*)arena;
+    return true;
+#endif
+}
+
+void arena_close() {
+#ifndef _WIN32
+    if (mem_system->arena) munmap(mem_system->arena, mem_system->arena_size);
+#endif
+    mem_system->arena = NULL;
+}
+
+// Tocar RAM_ARENA_TOUCH bytes del marco en una línea elegida por el tick
+void arena_touch(int frame_index, bool write) {
+    if (!mem_system->arena) return;
+    
+    size_t page_bytes = (size_t)PAGE_SIZE * 1024;
+    size_t lines = page_bytes / 64;
+    size_t offset = (size_t)(((sim_tick() * 0x9E3779B97F4A7C15ULL) >> 32) % lines) * 64;
+    size_t length = RAM_ARENA_TOUCH > 0 ? (size_t)RAM_ARENA_TOUCH : 8;
+    if (offset + length > page_bytes) length = page_bytes - offset;
+    
+    uint64_t *word = (uint64_t*)(mem_system->arena + (size_t)frame_index * page_bytes + offset);
+    size_t words = length / sizeof(uint64_t);
+    if (words == 0) words = 1;
+    
+    Core *core = this_core();
+    if (write) {
+        for (size_t i = 0; i < words; i++) word[i] += sim_tick();
+    } else {
+        uint64_t sum = 0;
+        for (size_t i = 0; i < words; i++) sum += word[i];
+        core->arena_sink += sum;
+    }
+    core->arena_bytes_touched += words * sizeof(uint64_t);
+}
+
+// Rellenar el marco completo al traer una página (copia del swap in)
+void arena_fill(int frame_index) {
+    if (!mem_system->arena) return;
+    
+    size_t page_bytes = (size_t)PAGE_SIZE * 1024;
+    memset(mem_system->arena + (size_t)frame_index * page_bytes, 
+           (int)(sim_tick() & 0xFF), page_bytes);
+    mem_system->arena_bytes_filled += page_bytes;
+}
+
+// ==================== DISPOSITIVO DE SWAP ====================
+// Con SWAP_FILE configurado, cada swap out/in hace un pwrite/pread real de
+// una página y mide su latencia para contrastarla con COST_SWAP_*.
+// Con SWAP_IO = IO_URING o THREADS las escrituras no bloquean al simulador:
+// quedan en la tabla de peticiones en curso y la ranura no se reutiliza
+// hasta que terminan. Un fallo sobre una ranura con una petición en curso
+// espera esa misma petición (o copia el búfer de la escritura pendiente).
+
+#ifndef _WIN32
+static unsigned long long elapsed_ns(const struct timespec *start, const struct timespec *end) {
+    return (unsigned long long)(end->tv_sec - start->tv_sec) * 1000000000ULL + 
+           (unsigned long long)(end->tv_nsec - start->tv_nsec);
+}
+
+// Registrar una operación completada (latencia, sello, ventana de IOPS)
+static bool swap_io_account(bool write, long result, const unsigned char *buffer, 
+                            int pid, int page_number,
+                            const struct timespec *start, const struct timespec *end) {
+    SwapDevice *dev = &mem_system->swap_dev;
+    if (result != (long)dev->block_size) {
+        dev->errors++;
+        return false;
+    }
+    
+    unsigned long long ns = elapsed_ns(start, end);
+    if (write) {
+        dev->writes++;
+        dev->write_ns += ns;
+        if (ns > dev->write_ns_max) dev->write_ns_max = ns;
+    } else {
+        dev->reads++;
+        dev->read_ns += ns;
+        if (ns > dev->read_ns_max) dev->read_ns_max = ns;
+        
+        // Una ranura nunca escrita (página creada directamente en Swap) se lee en ceros
+        SwapPageStamp stamp;
+        memcpy(&stamp, buffer, sizeof(stamp));
+        if (stamp.magic == SWAP_STAMP_MAGIC && 
+            (stamp.pid != pid || stamp.page_number != page_number)) {
+            dev->mismatches++;
+        }
+    }
+    
+    if (dev->first_submit.tv_sec == 0 && dev->first_submit.tv_nsec == 0) {
+        dev->first_submit = *start;
+    }
+    dev->last_complete = *end;
+    return true;
+}
+
+// E/S síncrona en el hilo del simulador
+static bool swap_io_sync(int swap_index, bool write, int pid, int page_number) {
+    SwapDevice *dev = &mem_system->swap_dev;
+    if (write) {
+        SwapPageStamp stamp = { SWAP_STAMP_MAGIC, pid, page_number, 0 };
+        memcpy(dev->buffer, &stamp, sizeof(stamp));
+    }
+    
+    struct timespec start, end;
+    off_t offset = (off_t)swap_index * (off_t)dev->block_size;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    ssize_t done = write ? pwrite(dev->fd, dev->buffer, dev->block_size, offset)
+                         : pread(dev->fd, dev->buffer, dev->block_size, offset);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    
+    dev->submitted++;
+    dev->depth_sum++;
+    if (dev->depth_max < 1) dev->depth_max = 1;
+    return swap_io_account(write, (long)done, dev->buffer, pid, page_number, &start, &end);
+}
+
+#if SWAP_HAVE_IO_URING
+static int sys_io_uring_setup(unsigned entries, struct io_uring_params *params) {
+    return (int)syscall(__NR_io_uring_setup, entries, params);
+}
+
+static int sys_io_uring_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+    return (int)syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, NULL, 0);
+}
+
+// Crear el anillo y mapear las colas de envío y de completado
+static bool io_uring_open(IoUring *ring, unsigned entries) {
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    memset(ring, 0, sizeof(*ring));
+    
+    ring->fd = sys_io_uring_setup(entries, &params);
+    if (ring->fd < 0) {
+        ring->fd = -1;
+        return false;
+    }
+    
+    ring->sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ring->cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        if (ring->cq_ring_size > ring->sq_ring_size) ring->sq_ring_size = ring->cq_ring_size;
+        ring->cq_ring_size = 0;
+    }
+    
+    ring->sq_ring = mmap(NULL, ring->sq_ring_size, PROT_READ | PROT_WRITE, 
+                         MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+    ring->cq_ring = ring->sq_ring;
+    if (ring->sq_ring != MAP_FAILED && ring->cq_ring_size > 0) {
+        ring->cq_ring = mmap(NULL, ring->cq_ring_size, PROT_READ | PROT_WRITE, 
+                             MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_CQ_RING);
+    }
+    ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    ring->sqes = (struct io_uring_sqe*)mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE, 
+                                            MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+    if (ring->sq_ring == MAP_FAILED || ring->cq_ring == MAP_FAILED || 
+        (void*)ring->sqes == MAP_FAILED) {
+        if (ring->sq_ring != MAP_FAILED) munmap(ring->sq_ring, ring->sq_ring_size);
+        if (ring->cq_ring_size > 0 && ring->cq_ring != MAP_FAILED) munmap(ring->cq_ring, ring->cq_ring_size);
+        if ((void*)ring->sqes != MAP_FAILED) munmap(ring->sqes, ring->sqes_size);
+        close(ring->fd);
+        ring->fd = -1;
+        return false;
+    }
+    
+    unsigned char *sq = (unsigned char*)ring->sq_ring;
+    unsigned char *cq = (unsigned char*)ring->cq_ring;
+    ring->sq_head = (unsigned*)(sq + params.sq_off.head);
+    ring->sq_tail = (unsigned*)(sq + params.sq_off.tail);
+    ring->sq_mask = (unsigned*)(sq + params.sq_off.ring_mask);
+    ring->sq_array = (unsigned*)(sq + params.sq_off.array);
+    ring->cq_head = (unsigned*)(cq + params.cq_off.head);
+    ring->cq_tail = (unsigned*)(cq + params.cq_off.tail);
+    ring->cq_mask = (unsigned*)(cq + params.cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe*)(cq + params.cq_off.cqes);
+    return true;
+}
+
+static void io_uring_close(IoUring *ring) {
+    if (ring->fd == -1) return;
+    munmap(ring->sqes, ring->sqes_size);
+    if (ring->cq_ring_size > 0) munmap(ring->cq_ring, ring->cq_ring_size);
+    munmap(ring->sq_ring, ring->sq_ring_size);
+    close(ring->fd);
+    ring->fd = -1;
+}
+
+// Encolar una lectura/escritura de la petición index y avisar al kernel.
+// Devuelve true si el kernel tomó la SQE: entonces la petición solo se
+// completa con su CQE. Si no la tomó, la SQE se retira de la cola para que
+// un io_uring_enter posterior no la envíe con un índice ya reutilizado.
+static bool io_uring_submit(IoUring *ring, int index, const SwapRequest *req, int fd, size_t len) {
+    unsigned tail = *ring->sq_tail;
+    unsigned slot = tail & *ring->sq_mask;
+    struct io_uring_sqe *sqe = &ring->sqes[slot];
+    
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = req->write ? IORING_OP_WRITE : IORING_OP_READ;
+    sqe->fd = fd;
+    sqe->addr = (uint64_t)(uintptr_t)req->buffer;
+    sqe->len = (uint32_t)len;
+    sqe->off = (uint64_t)req->swap_index * len;
+    sqe->user_data = (uint64_t)index;
+    ring->sq_array[slot] = slot;
+    __atomic_store_n(ring->sq_tail, tail + 1, __ATOMIC_RELEASE);
+    
+    for (int attempt = 0; attempt < 64; attempt++) {
+        int ret = sys_io_uring_enter(ring->fd, 1, 0, 0);
+        // Aunque la llamada falle, el kernel pudo haber consumido la SQE
+        if (ret == 1 || __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE) != tail) return true;
+        if (ret == -1 && errno != EINTR && errno != EAGAIN && errno != EBUSY) break;
+        if (ret == -1 && errno != EINTR) sched_yield();
+    }
+    
+    // Sin SQPOLL el kernel solo lee la cola dentro de io_uring_enter
+    __atomic_store_n(ring->sq_tail, tail, __ATOMIC_RELEASE);
+    return false;
+}
+
+// Marcar como terminadas las peticiones que el kernel ya completó
+static void io_uring_reap(IoUring *ring, SwapRequest *requests) {
+    unsigned head = *ring->cq_head;
+    unsigned tail = __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE);
+    while (head != tail) {
+        const struct io_uring_cqe *cqe = &ring->cqes[head & *ring->cq_mask];
+        SwapRequest *req = &requests[cqe->user_data];
+        req->result = cqe->res;
+        clock_gettime(CLOCK_MONOTONIC, &req->completed);
+        req->done = true;
+        head++;
+    }
+    __atomic_store_n(ring->cq_head, head, __ATOMIC_RELEASE);
+}
+#endif
+
+// Hilo de E/S del grupo de hilos: atiende la cola de peticiones
+static void* swap_io_worker(void *arg) {
+    SwapDevice *dev = (SwapDevice*)arg;
+    pthread_mutex_lock(&dev->lock);
+    for (;;) {
+        while (dev->queue_count == 0 && !dev->stopping) {
+            pthread_cond_wait(&dev->work_ready, &dev->lock);
+        }
+        if (dev->queue_count == 0) break;
+        
+        int index = dev->queue[dev->queue_head];
+        dev->queue_head = (dev->queue_head + 1) % dev->queue_depth;
+        dev->queue_count--;
+        SwapRequest *req = &dev->requests[index];
+        pthread_mutex_unlock(&dev->lock);
+        
+        off_t offset = (off_t)req->swap_index * (off_t)dev->block_size;
+        ssize_t done = req->write ? pwrite(dev->fd, req->buffer, dev->block_size, offset)
+                                  : pread(dev->fd, req->buffer, dev->block_size, offset);
+        
+        pthread_mutex_lock(&dev->lock);
+        req->result = (long)done;
+        clock_gettime(CLOCK_MONOTONIC, &req->completed);
+        req->done = true;
+        pthread_cond_broadcast(&dev->work_done);
+    }
+    pthread_mutex_unlock(&dev->lock);
+    return NULL;
+}
+
+// Procesar una petición terminada y liberar su entrada (solo el simulador)
+static bool swap_io_complete(int index) {
+    SwapDevice *dev = &mem_system->swap_dev;
+    SwapRequest *req = &dev->requests[index];
+    bool ok = swap_io_account(req->write, req->result, req->buffer, req->pid, 
+                              req->page_number, &req->submitted, &req->completed);
+    if (!ok) {
+        LOG_ERROR(EVENT_SWAP_ASYNC_ERROR, .pid = req->pid, 
+                  .page_number = req->page_number, .swap_slot = req->swap_index,
+                  .value = req->write);
+    }
+    
+    dev->slot_request[req->swap_index] = -1;
+    if (req->release_on_done) {
+        bitmap_set_free(&mem_system->swap_free, req->swap_index);
+    }
+    req->swap_index = -1;
+    req->done = false;
+    dev->in_flight--;
+    return ok;
+}
+
+// Procesar todas las peticiones terminadas sin bloquear
+static void swap_io_reap(void) {
+    SwapDevice *dev = &mem_system->swap_dev;
+#if SWAP_HAVE_IO_URING
+    if (dev->backend == SWAP_BACKEND_URING) io_uring_reap(&dev->ring, dev->requests);
+#endif
+    if (dev->backend == SWAP_BACKEND_THREADS) pthread_mutex_lock(&dev->lock);
+    for (int i = 0; i < dev->queue_depth; i++) {
+        if (dev->requests[i].swap_index != -1 && dev->requests[i].done) {
+            swap_io_complete(i);
+        }
+    }
+    if (dev->backend == SWAP_BACKEND_THREADS) pthread_mutex_unlock(&dev->lock);
+}
+
+// Bloquear hasta que termine la petición index (o cualquiera si index = -1)
+static void swap_io_wait(int index) {
+    SwapDevice *dev = &mem_system->swap_dev;
+#if SWAP_HAVE_IO_URING
+    if (dev->backend == SWAP_BACKEND_URING) {
+        for (;;) {
+            io_uring_reap(&dev->ring, dev->requests);
+            bool ready = false;
+            for (int i = 0; i < dev->queue_depth && !ready; i++) {
+                ready = dev->requests[i].swap_index != -1 && dev->requests[i].done && 
+                        (index == -1 || i == index);
+            }
+            if (ready) return;
+            sys_io_uring_enter(dev->ring.fd, 0, 1, IORING_ENTER_GETEVENTS);
+        }
+    }
+#endif
+    pthread_mutex_lock(&dev->lock);
+    for (;;) {
+        bool ready = false;
+        for (int i = 0; i < dev->queue_depth && !ready; i++) {
+            ready = dev->requests[i].swap_index != -1 && dev->requests[i].done && 
+                    (index == -1 || i == index);
+        }
+        if (ready) break;
+        pthread_cond_wait(&dev->work_done, &dev->lock);
+    }
+    pthread_mutex_unlock(&dev->lock);
+}
+
+// Enviar una petición asíncrona; devuelve su índice en la tabla
+static int swap_io_submit(int swap_index, bool write, int pid, int page_number) {
+    SwapDevice *dev = &mem_system->swap_dev;
+    swap_io_reap();
+    
+    // Cola llena: esperar a que termine alguna petición
+    while (dev->in_flight == dev->queue_depth) {
+        swap_io_wait(-1);
+        swap_io_reap();
+    }
+    
+    int index = 0;
+    while (dev->requests[index].swap_index != -1) index++;
+    SwapRequest *req = &dev->requests[index];
+    req->swap_index = swap_index;
+    req->write = write;
+    req->pid = pid;
+    req->page_number = page_number;
+    req->done = false;
+    req->result = 0;
+    req->release_on_done = false;
+    if (write) {
+        SwapPageStamp stamp = { SWAP_STAMP_MAGIC, pid, page_number, 0 };
+        memcpy(req->buffer, &stamp, sizeof(stamp));
+    }
+    clock_gettime(CLOCK_MONOTONIC, &req->submitted);
+    
+    dev->slot_request[swap_index] = index;
+    dev->in_flight++;
+    dev->submitted++;
+    dev->depth_sum += dev->in_flight;
+    if (dev->in_flight > dev->depth_max) dev->depth_max = dev->in_flight;
+    
+#if SWAP_HAVE_IO_URING
+    if (dev->backend == SWAP_BACKEND_URING) {
+        if (!io_uring_submit(&dev->ring, index, req, dev->fd, dev->block_size)) {
+            // La SQE no quedó en la cola: se puede completar ya con error
+            req->result = -1;
+            clock_gettime(CLOCK_MONOTONIC, &req->completed);
+            req->done = true;
+        }
+        return index;
+    }
+#endif
+    pthread_mutex_lock(&dev->lock);
+    dev->queue[(dev->queue_head + dev->queue_count) % dev->queue_depth] = index;
+    dev->queue_count++;
+    pthread_cond_signal(&dev->work_ready);
+    pthread_mutex_unlock(&dev->lock);
+    return index;
+}
+
+// Esperar la petición index y procesarla; devuelve si terminó bien
+static bool swap_io_finish(int index) {
+    SwapDevice *dev = &mem_system->swap_dev;
+    swap_io_wait(index);
+    if (dev->backend == SWAP_BACKEND_THREADS) pthread_mutex_lock(&dev->lock);
+    bool ok = swap_io_complete(index);
+    if (dev->backend == SWAP_BACKEND_THREADS) pthread_mutex_unlock(&dev->lock);
+    swap_io_reap();
+    return ok;
+}
+
+// Terminar las peticiones pendientes y detener el backend
+static void swap_io_stop(void) {
+    SwapDevice *dev = &mem_system->swap_dev;
+    if (!dev->requests) return;
+    
+    while (dev->in_flight > 0) {
+        swap_io_wait(-1);
+        swap_io_reap();
+    }
+#if SWAP_HAVE_IO_URING
+    if (dev->backend == SWAP_BACKEND_URING) io_uring_close(&dev->ring);
+#endif
+    if (dev->backend == SWAP_BACKEND_THREADS) {
+        pthread_mutex_lock(&dev->lock);
+        dev->stopping = true;
+        pthread_cond_broadcast(&dev->work_ready);
+        pthread_mutex_unlock(&dev->lock);
+        for (int i = 0; i < dev->num_threads; i++) pthread_join(dev->threads[i], NULL);
+        pthread_mutex_destroy(&dev->lock);
+        pthread_cond_destroy(&dev->work_ready);
+        pthread_cond_destroy(&dev->work_done);
+        free(dev->threads);
+    }
+    for (int i = 0; i < dev->queue_depth; i++) free(dev->requests[i].buffer);
+    free(dev->requests);
+    free(dev->queue);
+    free(dev->slot_request);
+    // Un segundo swap_io_stop (p. ej. al cerrar el dispositivo) no hace nada
+    dev->requests = NULL;
+    dev->queue = NULL;
+    dev->slot_request = NULL;
+    dev->threads = NULL;
+    dev->queue_depth = dev->num_threads = 0;
+    dev->backend = SWAP_BACKEND_SYNC;
+}
+
+// Preparar la tabla de peticiones y el backend asíncrono
+static bool swap_io_start(SwapIoBackend backend) {
+    SwapDevice *dev = &mem_system->swap_dev;
+    dev->queue_depth = SWAP_QUEUE_DEPTH > 0 ? SWAP_QUEUE_DEPTH : 1;
+    dev->requests = (SwapRequest*)calloc(dev->queue_depth, sizeof(SwapRequest));
+    dev->queue = (int*)malloc(dev->queue_depth * sizeof(int));
+    dev->slot_request = (int*)malloc(NUM_SWAP_FRAMES * sizeof(int));
+    for (int i = 0; i < NUM_SWAP_FRAMES; i++) dev->slot_request[i] = -1;
+    for (int i = 0; i < dev->queue_depth; i++) {
+        dev->requests[i].swap_index = -1;
+        if (posix_memalign((void**)&dev->requests[i].buffer, 4096, dev->block_size) != 0) {
+            // Sin backend todavía: solo se libera la tabla de peticiones
+            dev->requests[i].buffer = NULL;
+            swap_io_stop();
+            return false;
+        }
+        memset(dev->requests[i].buffer, 0, dev->block_size);
+    }
+    
+#if SWAP_HAVE_IO_URING
+    if (backend == SWAP_BACKEND_URING) {
+        if (io_uring_open(&dev->ring, (unsigned)dev->queue_depth)) {
+            dev->backend = SWAP_BACKEND_URING;
+            return true;
+        }
+        printf("⚠️  io_uring no está disponible. Se usará un grupo de hilos de E/S.\n");
+    }
+#else
+    if (backend == SWAP_BACKEND_URING) {
+        printf("⚠️  io_uring no está disponible. Se usará un grupo de hilos de E/S.\n");
+    }
+#endif
+    
+    pthread_mutex_init(&dev->lock, NULL);
+    pthread_cond_init(&dev->work_ready, NULL);
+    pthread_cond_init(&dev->work_done, NULL);
+    dev->num_threads = SWAP_IO_THREADS > 0 ? SWAP_IO_THREADS : 1;
+    dev->threads = (pthread_t*)malloc(dev->num_threads * sizeof(pthread_t));
+    dev->backend = SWAP_BACKEND_THREADS;
+    for (int i = 0; i < dev->num_threads; i++) {
+        if (pthread_create(&dev->threads[i], NULL, swap_io_worker, dev) != 0) {
+            dev->num_threads = i;
+            break;
+        }
+    }
+    return dev->num_threads > 0;
+}
+#endif
+
+// Nombre del backend para la salida
+const char* swap_io_backend_name(SwapIoBackend backend) {
+    switch (backend) {
+        case SWAP_BACKEND_URING: return "io_uring";
+        case SWAP_BACKEND_THREADS: return "grupo de hilos";
+        default: return "síncrona";
+    }
+}
+
+// Abrir (o crear) el archivo de swap con SWAP_SIZE KB
+bool swap_device_open() {
+    SwapDevice *dev = &mem_system->swap_dev;
+    memset(dev, 0, sizeof(*dev));
+    dev->fd = -1;
+    dev->backend = SWAP_BACKEND_SYNC;
+    
+#ifdef _WIN32
+    printf("❌ Error: El archivo de swap no está disponible en Windows.\n");
+    return false;
+#else
+    dev->block_size = (size_t)PAGE_SIZE * 1024;
+    int flags = O_RDWR | O_CREAT;
+    if (SWAP_DIRECT) {
+#ifdef O_DIRECT
+        flags |= O_DIRECT;
+        dev->direct = true;
+#else
+        printf("⚠️  O_DIRECT no está disponible en este sistema. Se usará la caché del SO.\n");
+#endif
+    }
+    
+    dev->fd = open(SWAP_FILE, flags, 0600);
+    if (dev->fd == -1) {
+        printf("❌ Error: No se pudo abrir el archivo de swap '%s'.\n", SWAP_FILE);
+        return false;
+    }
+    
+    // Un archivo regular se vacía (sin sellos de ejecuciones anteriores) y se
+    // ajusta al tamaño del Swap; un dispositivo de bloques se usa tal cual
+    struct stat st;
+    off_t size = (off_t)NUM_SWAP_FRAMES * (off_t)dev->block_size;
+    if (fstat(dev->fd, &st) == 0 && S_ISREG(st.st_mode) && 
+        (ftruncate(dev->fd, 0) != 0 || ftruncate(dev->fd, size) != 0)) {
+        printf("❌ Error: No se pudo reservar %d KB en el archivo de swap.\n", SWAP_SIZE);
+        close(dev->fd);
+        dev->fd = -1;
+        return false;
+    }
+    
+    // O_DIRECT exige búferes alineados
+    if (posix_memalign((void**)&dev->buffer, 4096, dev->block_size) != 0) {
+        close(dev->fd);
+        dev->fd = -1;
+        return false;
+    }
+    memset(dev->buffer, 0, dev->block_size);
+    
+    // Backend asíncrono (si no arranca, se sigue con E/S síncrona)
+    if (strcmp(SWAP_IO, "IO_URING") == 0 || strcmp(SWAP_IO, "THREADS") == 0) {
+        if (!swap_io_start(strcmp(SWAP_IO, "IO_URING") == 0 ? SWAP_BACKEND_URING : SWAP_BACKEND_THREADS)) {
+            printf("⚠️  No se pudo iniciar la E/S asíncrona de swap. Se usará E/S síncrona.\n");
+            swap_io_stop();
+        }
+    } else if (strcmp(SWAP_IO, "SYNC") != 0) {
+        printf("⚠️  SWAP_IO '%s' desconocido. Se usará E/S síncrona.\n", SWAP_IO);
+    }
+    return true;
+#endif
+}
+
+void swap_device_close() {
+    SwapDevice *dev = &mem_system->swap_dev;
+#ifndef _WIN32
+    swap_io_stop();
+    if (dev->fd != -1) close(dev->fd);
+#endif
+    free(dev->buffer);
+    dev->buffer = NULL;
+    dev->fd = -1;
+}
+
+// Escribir una página en su ranura (no hace nada sin dispositivo)
+// Con un backend asíncrono la escritura queda en curso y no se espera.
+bool swap_device_write(int swap_index, int pid, int page_number) {
+    SwapDevice *dev = &mem_system->swap_dev;
+    if (dev->fd == -1) return true;
+    
+#ifdef _WIN32
+    (void)swap_index; (void)pid; (void)page_number;
+    return false;
+#else
+    if (dev->backend == SWAP_BACKEND_SYNC) {
+        return swap_io_sync(swap_index, true, pid, page_number);
+    }
+    
+    // La ranura no puede tener otra petición: esperar a que termine
+    if (dev->slot_request[swap_index] != -1) {
+        swap_io_finish(dev->slot_request[swap_index]);
+    }
+    swap_io_submit(swap_index, true, pid, page_number);
+    return true;
+#endif
+}
+
+// Leer la página de una ranura y comprobar su sello
+bool swap_device_read(int swap_index, int pid, int page_number) {
+    SwapDevice *dev = &mem_system->swap_dev;
+    if (dev->fd == -1) return true;
+    
+#ifdef _WIN32
+    (void)swap_index; (void)pid; (void)page_number;
+    return false;
+#else
+    if (dev->backend == SWAP_BACKEND_SYNC) {
+        return swap_io_sync(swap_index, false, pid, page_number);
+    }
+    
+    int index = dev->slot_request[swap_index];
+    if (index != -1 && dev->requests[index].write) {
+        // La página aún se está escribiendo: su contenido está en el búfer
+        memcpy(dev->buffer, dev->requests[index].buffer, dev->block_size);
+        dev->forwarded++;
+        return true;
+    }
+    if (index != -1) {
+        // Ya hay una lectura en curso de la misma ranura: esperarla
+        dev->joins++;
+        return swap_io_finish(index);
+    }
+    return swap_io_finish(swap_io_submit(swap_index, false, pid, page_number));
+#endif
+}
+
+// Leer una página por adelantado sin esperar (con backend asíncrono)
+bool swap_device_prefetch(int swap_index, int pid, int page_number) {
+    SwapDevice *dev = &mem_system->swap_dev;
+    if (dev->fd == -1) return true;
+    
+#ifdef _WIN32
+    (void)swap_index; (void)pid; (void)page_number;
+    return false;
+#else
+    if (dev->backend == SWAP_BACKEND_SYNC) {
+        return swap_io_sync(swap_index, false, pid, page_number);
+    }
+    int index = dev->slot_request[swap_index];
+    if (index != -1 && dev->requests[index].write) {
+        // Escritura aún en curso: la página se toma de su búfer
+        dev->forwarded++;
+        return true;
+    }
+    if (index != -1) {
+        // Ya hay una lectura en curso de la misma ranura
+        dev->joins++;
+        return true;
+    }
+    swap_io_submit(swap_index, false, pid, page_number);
+    return true;
+#endif
+}
+
+// Esperar la lectura en curso de una ranura (página traída por adelantado)
+void swap_device_wait(int swap_index) {
+#ifdef _WIN32
+    (void)swap_index;
+#else
+    SwapDevice *dev = &mem_system->swap_dev;
+    if (dev->backend == SWAP_BACKEND_SYNC || swap_index < 0) return;
+    
+    int index = dev->slot_request[swap_index];
+    if (index != -1 && !dev->requests[index].write) {
+        dev->joins++;
+        swap_io_finish(index);
+    }
+#endif
+}
+
+// Conservar una ranura ocupada mientras tenga una petición en curso;
+// se libera en el mapa de bits cuando la petición termina
+bool swap_device_defer_release(int swap_index) {
+#ifdef _WIN32
+    (void)swap_index;
+    return false;
+#else
+    SwapDevice *dev = &mem_system->swap_dev;
+    if (dev->backend == SWAP_BACKEND_SYNC || dev->slot_request[swap_index] == -1) {
+        return false;
+    }
+    dev->requests[dev->slot_request[swap_index]].release_on_done = true;
+    dev->deferred_releases++;
+    return true;
+#endif
+}
+
+// ==================== CACHÉ DE SWAP ====================
+// Tras un swap in la página conserva su ranura mientras siga limpia; volver
+// a expulsarla no escribe nada. Las ranuras en caché se recuperan (LRU)
+// cuando el Swap se queda sin ranuras libres.
+
+// Registrar la ranura de una página recién traída a RAM
+static void swap_cache_insert(int swap_index) {
+    if (mem_system->swap_cached[swap_index]) return;
+    mem_system->swap_cached[swap_index] = true;
+    index_list_push(&mem_system->swap_cache, mem_system->swap_cache_prev, 
+                    mem_system->swap_cache_next, swap_index);
+}
+
+// Quitar una ranura de la caché (la ranura sigue ocupada)
+static void swap_cache_remove(int swap_index) {
+    if (!mem_system->swap_cached[swap_index]) return;
+    mem_system->swap_cached[swap_index] = false;
+    index_list_remove(&mem_system->swap_cache, mem_system->swap_cache_prev, 
+                      mem_system->swap_cache_next, swap_index);
+}
+
+// Descartar la copia en Swap de una página residente (modificada o terminada)
+static void swap_cache_drop(PageTableEntry *entry) {
+    int swap_index = entry->swap_position;
+    if (entry->state != PAGE_IN_RAM || swap_index < 0) return;
+    swap_cache_remove(swap_index);
+    release_swap_frame(swap_index);
+    entry->swap_position = -1;
+}
+
+// Obtener una ranura de Swap, recuperando la más antigua de la caché si no
+// quedan libres (-1 si el Swap está lleno de páginas expulsadas)
+int allocate_swap_slot() {
+    int swap_index = find_free_swap_frame();
+    if (swap_index != -1 || mem_system->swap_cache.head == -1) {
+        return swap_index;
+    }
+    
+    int victim = mem_system->swap_cache.head;
+    PCB *owner = find_process(mem_system->swap_frames.pid[victim]);
+    if (owner) {
+        swap_cache_drop(page_table_lookup(owner, mem_system->swap_frames.page_number[victim]));
+    } else {
+        swap_cache_remove(victim);
+        release_swap_frame(victim);
+    }
+    mem_system->total_swap_cache_reclaims++;
+    
+    return find_free_swap_frame();
+}
+
+// Asignar un marco ya reservado en el asignador a una página
+static void frame_claim(int frame_index, int pid, int page_number) {
+    FrameTable *frames = &mem_system->ram_frames;
+    frames->pid[frame_index] = pid;
+    frames->page_number[frame_index] = page_number;
+    frames->load_time[frame_index] = sim_tick();
+    bitmap_set_used(&mem_system->ram_free, frame_index);
+}
+
+// Por debajo de la marca baja kswapd empieza a reclamar
+static void kswapd_check_watermark(void) {
+    if (mem_system->kswapd_running && !mem_system->kswapd_woken &&
+        mem_system->ram_free.free_count < mem_system->watermark_low) {
+        __atomic_store_n(&mem_system->kswapd_woken, true, __ATOMIC_RELAXED);
+#ifndef _WIN32
+        pthread_cond_signal(&mem_system->kswapd_wait);
+#endif
+    }
+}
+
+// Ocupar un marco de RAM (mantiene el mapa de bits sincronizado)
+void occupy_ram_frame(int frame_index, int pid, int page_number) {
+    if (HUGE_PAGE_ORDER > 0) buddy_take(&mem_system->buddy, frame_index);
+    frame_claim(frame_index, pid, page_number);
+    mem_system->policy->on_load(frame_index);
+    kswapd_check_watermark();
+}
+
+// Liberar un marco de RAM
+void release_ram_frame(int frame_index) {
+    FrameTable *frames = &mem_system->ram_frames;
+    if (HUGE_PAGE_ORDER > 0 && frames->pid[frame_index] != -1) buddy_free(&mem_system->buddy, frame_index);
+    frames->pid[frame_index] = -1;
+    frames->page_number[frame_index] = -1;
+    bitmap_set_free(&mem_system->ram_free, frame_index);
+    mem_system->policy->on_free(frame_index);
+}
+
+// Ocupar un marco de Swap
+void occupy_swap_frame(int swap_index, int pid, int page_number) {
+    FrameTable *frames = &mem_system->swap_frames;
+    frames->pid[swap_index] = pid;
+    frames->page_number[swap_index] = page_number;
+    frames->load_time[swap_index] = sim_tick();
+    bitmap_set_used(&mem_system->swap_free, swap_index);
+}
+
+// Liberar un marco de Swap
+void release_swap_frame(int swap_index) {
+    FrameTable *frames = &mem_system->swap_frames;
+    frames->pid[swap_index] = -1;
+    frames->page_number[swap_index] = -1;
+    
+    // Con E/S en curso la ranura sigue reservada hasta que termine
+    if (!swap_device_defer_release(swap_index)) {
+        bitmap_set_free(&mem_system->swap_free, swap_index);
+    }
+}
+
+// Seleccionar el marco víctima según la política activa
+int select_victim_page(int pid, int page_number) {
+    return mem_system->policy->choose_victim(pid, page_number);
+}
+
+// Mover el cabezal del Swap a una ranura; si no sigue a la última E/S se
+// cobra un posicionamiento
+static void swap_seek(int swap_index) {
+    if (swap_index != mem_system->swap_last_slot + 1) {
+        mem_system->total_swap_seeks++;
+        mem_system->sim_time_ns += COST_SWAP_SEEK;
+    }
+    mem_system->swap_last_slot = swap_index;
+}
+
+// La página del marco tiene en Swap una copia vigente (expulsarla no escribe)
+static bool frame_has_swap_copy(int frame_index) {
+    const FrameTable *swap = &mem_system->swap_frames;
+    int page_number = mem_system->ram_frames.page_number[frame_index];
+    PCB *process = find_process(mem_system->ram_frames.pid[frame_index]);
+    if (!process) {
+        return false;
+    }
+    
+    const PageTableEntry *page_entry = page_table_lookup(process, page_number);
+    int swap_frame = page_entry->swap_position;
+    return !page_entry->modified && swap_frame >= 0 && swap_frame < NUM_SWAP_FRAMES &&
+           swap->pid[swap_frame] == process->pid &&
+           swap->page_number[swap_frame] == page_number;
+}
+
+// Marcos que libera expulsar la víctima: los de toda la página grande si el
+// marco es el inicio de una (la política solo registra ese marco)
+static int frame_span(int frame_index) {
+    if (HUGE_PAGE_ORDER == 0) {
+        return 1;
+    }
+    int pid = mem_system->ram_frames.pid[frame_index];
+    PCB *process = pid != -1 ? find_process(pid) : NULL;
+    if (!process) {
+        return 1;
+    }
+    const PageTableEntry *page_entry = page_table_lookup(process, mem_system->ram_frames.page_number[frame_index]);
+    return page_entry && page_entry->huge ? 1 << HUGE_PAGE_ORDER : 1;
+}
+
+// Alguna página de la víctima (base o grande) tiene que escribirse
+static bool victim_needs_write(int frame_index) {
+    int span = frame_span(frame_index);
+    for (int k = 0; k < span; k++) {
+        if (!frame_has_swap_copy(frame_index + k)) return true;
+    }
+    return false;
+}
+
+// Expulsar una página grande entera: sus páginas van al Swap como páginas
+// base (a partir de swap_slot si la reclamación reservó una racha) y el
+// bloque vuelve al buddy de una pieza. Si una escritura falla a medias, lo
+// que queda en RAM se parte en páginas base.
+static bool swap_out_huge_page(int frame_index, int swap_slot) {
+    PCB *process = find_process(mem_system->ram_frames.pid[frame_index]);
+    int pid = process->pid;
+    int span = 1 << HUGE_PAGE_ORDER;
+    int base = mem_system->ram_frames.page_number[frame_index];
+    
+    int needed = 0;
+    for (int k = 0; k < span; k++) {
+        if (!frame_has_swap_copy(frame_index + k)) needed++;
+    }
+    if (swap_slot < 0 && needed > mem_system->swap_free.free_count + mem_system->swap_cache.size) {
+        LOG_ERROR(EVENT_HUGE_SWAP_FULL, .pid = pid, .page_number = base, .count = span);
+        return false;
+    }
+    
+    tlb_invalidate_huge(pid, base);
+    int written = 0;
+    int moved = 0;
+    for (; moved < span; moved++) {
+        PageTableEntry *page_entry = page_table_lookup(process, base + moved);
+        int swap_frame = page_entry->swap_position;
+        
+        if (frame_has_swap_copy(frame_index + moved)) {
+            swap_cache_remove(swap_frame);
+            mem_system->total_swap_cache_hits++;
+            mem_system->total_clean_evictions++;
+        } else {
+            mem_system->total_swap_cache_misses++;
+            swap_frame = swap_slot >= 0 ? swap_slot + written : allocate_swap_slot();
+            if (swap_frame == -1 || !swap_device_write(swap_frame, pid, base + moved)) {
+                LOG_ERROR(EVENT_HUGE_WRITE_ERROR, .pid = pid, .page_number = base + moved);
+                break;
+            }
+            occupy_swap_frame(swap_frame, pid, base + moved);
+            written++;
+            mem_system->total_swap_writes++;
+            mem_system->sim_time_ns += COST_SWAP_WRITE;
+            swap_seek(swap_frame);
+            if (swap_frame != mem_system->swap_last_write + 1) {
+                mem_system->total_write_clusters++;
+            }
+            mem_system->swap_last_write = swap_frame;
+        }
+        
+        page_entry->state = PAGE_IN_SWAP;
+        page_entry->frame_number = -1;
+        page_entry->swap_position = swap_frame;
+        page_entry->valid = false;
+        page_entry->modified = false;
+        page_entry->huge = false;
+    }
+    if (moved == 0) {
+        return false; // Sigue entera en RAM
+    }
+    
+    // Lo que no salió queda en RAM como páginas base, cada una en la política
+    for (int k = moved; k < span; k++) {
+        page_table_lookup(process, base + k)->huge = false;
+        mem_system->policy->on_load(frame_index + k);
+    }
+    
+    if (mem_system->policy->on_evict) mem_system->policy->on_evict(frame_index);
+    for (int k = 0; k < moved; k++) {
+        release_ram_frame(frame_index + k);
+    }
+    mem_system->huge_resident--;
+    mem_system->total_huge_evictions++;
+    
+    LOG_DEBUG(EVENT_HUGE_SWAP_OUT, .pid = pid, .page_number = base, 
+              .frame = frame_index, .count = moved, .value = written);
+    return true;
+}
+
+// Intercambiar página de RAM a Swap (Swap Out)
+// swap_slot es la ranura reservada por la reclamación por lotes para una
+// página que debe escribirse (-1 = buscar una)
+static bool swap_out_page_to(int frame_index, int swap_slot) {
+    if (frame_index < 0 || frame_index >= NUM_RAM_FRAMES) {
+        return false;
+    }
+    
+    int pid = mem_system->ram_frames.pid[frame_index];
+    if (pid == -1) {
+        return false;
+    }
+    if (frame_span(frame_index) > 1) {
+        return swap_out_huge_page(frame_index, swap_slot);
+    }
+    
+    // Buscar proceso y página
+    PCB *process = find_process(pid);
+    if (!process) {
+        return false;
+    }
+    
+    int page_number = mem_system->ram_frames.page_number[frame_index];
+    PageTableEntry *page_entry = page_table_lookup(process, page_number);
+    
+    // Retirar primero la traducción de todas las TLB: desde aquí ningún
+    // núcleo puede acertar sobre el marco que se va a liberar
+    tlb_invalidate_page(process->pid, page_number);
+    
+    // Una página limpia cuya copia en Swap sigue vigente no se escribe
+    int swap_frame = page_entry->swap_position;
+    bool clean = frame_has_swap_copy(frame_index);
+    
+    if (clean) {
+        // La ranura deja la caché: vuelve a ser la única copia de la página
+        swap_cache_remove(swap_frame);
+        mem_system->total_swap_cache_hits++;
+    } else {
+        mem_system->total_swap_cache_misses++;
+        
+        // Buscar espacio en Swap
+        swap_frame = swap_slot >= 0 ? swap_slot : allocate_swap_slot();
+        if (swap_frame == -1) {
+            LOG_ERROR(EVENT_SWAP_FULL, .pid = pid, .page_number = page_number);
+            return false;
+        }
+        
+        // Escribir página en Swap
+        if (!swap_device_write(swap_frame, pid, page_number)) {
+            LOG_ERROR(EVENT_SWAP_WRITE_ERROR, .pid = pid, 
+                      .page_number = page_number, .swap_slot = swap_frame);
+            return false;
+        }
+        occupy_swap_frame(swap_frame, pid, page_number);
+    }
+    
+    // Actualizar tabla de páginas
+    page_entry->state = PAGE_IN_SWAP;
+    page_entry->frame_number = -1;
+    page_entry->swap_position = swap_frame;
+    page_entry->valid = false;
+    page_entry->modified = false;
+    if (page_entry->prefetched) readahead_wasted(process, page_entry);
+    
+    // Liberar marco en RAM (la política ve la página antes de perderla)
+    if (mem_system->policy->on_evict) mem_system->policy->on_evict(frame_index);
+    release_ram_frame(frame_index);
+    
+    // Actualizar estadísticas
+    if (clean) {
+        mem_system->total_clean_evictions++;
+    } else {
+        mem_system->total_swap_writes++;
+        mem_system->sim_time_ns += COST_SWAP_WRITE;
+        swap_seek(swap_frame);
+        if (swap_frame != mem_system->swap_last_write + 1) {
+            mem_system->total_write_clusters++;
+        }
+        mem_system->swap_last_write = swap_frame;
+    }
+    LOG_DEBUG(clean ? EVENT_SWAP_OUT_CLEAN : EVENT_SWAP_OUT, .pid = pid, 
+              .page_number = page_number, .frame = frame_index, .swap_slot = swap_frame);
+    
+    return true;
+}
+
+bool swap_out_page(int frame_index) {
+    return swap_out_page_to(frame_index, -1);
+}
+
+// Orden de escritura de un lote: por proceso y después por página
+static int compare_victims(const void *a, const void *b) {
+    const FrameTable *ram = &mem_system->ram_frames;
+    int fa = *(const int*)a;
+    int fb = *(const int*)b;
+    if (ram->pid[fa] != ram->pid[fb]) return ram->pid[fa] < ram->pid[fb] ? -1 : 1;
+    return (ram->page_number[fa] > ram->page_number[fb]) - (ram->page_number[fa] < ram->page_number[fb]);
+}
+
+// ==================== RECLAMACIÓN POR LOTES ====================
+// Cuando un fallo no encuentra marco libre se aíslan hasta SWAP_CLUSTER
+// víctimas de la política (sin pasar de 1/8 de la RAM) y se expulsan juntas.
+// Las que deben escribirse se ordenan por proceso y página y van a una racha
+// contigua de ranuras si el Swap tiene una, de modo que las páginas vecinas
+// de un proceso quedan vecinas en el disco. Los marcos sobrantes quedan
+// libres para los siguientes fallos. Una página grande cuenta por todos sus
+// marcos.
+
+// Expulsar un lote de víctimas aisladas; devuelve los marcos liberados
+// Una página grande ocupa en la racha tantas ranuras como marcos tiene.
+static int swap_out_cluster(int *frames, int count) {
+    // Las víctimas sucias primero, en orden de proceso y página
+    int dirty = 0;
+    int dirty_pages = 0;
+    for (int i = 0; i < count; i++) {
+        if (victim_needs_write(frames[i])) {
+            dirty_pages += frame_span(frames[i]);
+            int tmp = frames[dirty];
+            frames[dirty++] = frames[i];
+            frames[i] = tmp;
+        }
+    }
+    qsort(frames, dirty, sizeof(int), compare_victims);
+    
+    // Sin racha contigua cada escritura busca su propia ranura
+    int run = dirty_pages > 1 ? bitmap_find_run(&mem_system->swap_free, dirty_pages) : -1;
+    
+    int free_before = mem_system->ram_free.free_count;
+    int offset = 0;
+    for (int i = 0; i < count; i++) {
+        int slot = (run != -1 && i < dirty) ? run + offset : -1;
+        if (i < dirty) offset += frame_span(frames[i]);
+        if (!swap_out_page_to(frames[i], slot) && mem_system->ram_frames.pid[frames[i]] != -1) {
+            // La víctima no se pudo expulsar: vuelve a la política
+            mem_system->policy->on_load(frames[i]);
+        }
+    }
+    return mem_system->ram_free.free_count - free_before;
+}
+
+// Víctimas por pasada según SWAP_CLUSTER (entre 1 y 1/8 de la RAM)
+static int reclaim_limit(void) {
+    int limit = SWAP_CLUSTER < NUM_RAM_FRAMES / 8 ? SWAP_CLUSTER : NUM_RAM_FRAMES / 8;
+    return limit < 1 ? 1 : limit;
+}
+
+// Una pasada de reclamación de hasta limit víctimas; devuelve los marcos
+// liberados. pid/page_number = -1 si no hay página entrante (kswapd).
+static int reclaim_pass(int pid, int page_number, int limit) {
+    int *batch = mem_system->reclaim_batch;
+    int count = 0;
+    int pages = 0;
+    while (pages < limit) {
+        int victim = select_victim_page(pid, page_number);
+        if (victim == -1) break;
+        
+        // Aislar la víctima para que la política proponga la siguiente
+        mem_system->policy->on_free(victim);
+        batch[count++] = victim;
+        pages += frame_span(victim);
+    }
+    if (count == 0) {
+        return 0;
+    }
+    
+    mem_system->total_reclaim_passes++;
+    int freed = swap_out_cluster(batch, count);
+    mem_system->total_reclaimed += freed;
+    return freed;
+}
+
+// Reclamación directa: el fallo libera marcos él mismo porque no encontró
+// ninguno libre. Devuelve un marco libre (-1 si no se pudo expulsar nada).
+int reclaim_ram_frames(int pid, int page_number) {
+    mem_system->total_direct_reclaims++;
+    return reclaim_pass(pid, page_number, reclaim_limit()) > 0 ? find_free_ram_frame() : -1;
+}
+
+// ==================== KSWAPD ====================
+// Con KSWAPD = 1 un hilo mantiene los marcos libres entre las marcas baja y
+// alta: occupy_ram_frame() lo despierta al bajar de la marca baja y kswapd
+// expulsa lotes hasta alcanzar la alta. Así los fallos suelen encontrar un
+// marco libre y la reclamación directa queda como respaldo. El estado del
+// sistema se protege con un único cerrojo que kswapd suelta entre lotes; su
+// E/S no se suma al reloj simulado de los accesos sino a kswapd_ns.
+
+#ifndef _WIN32
+static void *kswapd_main(void *arg) {
+    sim_attach((MemorySystem*)arg);
+    current_core = -1;
+    pthread_mutex_lock(&mem_system->lock);
+    while (!mem_system->kswapd_stopping) {
+        if (!mem_system->kswapd_woken) {
+            pthread_cond_wait(&mem_system->kswapd_wait, &mem_system->lock);
+            continue;
+        }
+        mem_system->total_kswapd_wakeups++;
+        
+        while (!mem_system->kswapd_stopping && 
+               mem_system->ram_free.free_count < mem_system->watermark_high) {
+            int wanted = mem_system->watermark_high - mem_system->ram_free.free_count;
+            int limit = reclaim_limit();
+            
+            unsigned long long before = mem_system->sim_time_ns;
+            int freed = reclaim_pass(-1, -1, wanted < limit ? wanted : limit);
+            mem_system->kswapd_ns += mem_system->sim_time_ns - before;
+            mem_system->sim_time_ns = before;
+            if (freed == 0) break;
+            
+            mem_system->total_kswapd_reclaims++;
+            mem_system->total_kswapd_reclaimed += freed;
+            
+            // Dejar pasar a los accesos entre lotes
+            pthread_mutex_unlock(&mem_system->lock);
+            sched_yield();
+            pthread_mutex_lock(&mem_system->lock);
+        }
+        __atomic_store_n(&mem_system->kswapd_woken, false, __ATOMIC_RELAXED);
+    }
+    pthread_mutex_unlock(&mem_system->lock);
+    return NULL;
+}
+#endif
+
+// Calcular las marcas y arrancar kswapd si está configurado
+void kswapd_start() {
+    mem_system->kswapd_running = false;
+    mem_system->kswapd_stopping = false;
+    mem_system->kswapd_woken = false;
+    
+    int low = NUM_RAM_FRAMES * WATERMARK_LOW / 100;
+    int high = NUM_RAM_FRAMES * WATERMARK_HIGH / 100;
+    if (low < 1) low = 1;
+    if (high <= low) high = low + 1;
+    if (high > NUM_RAM_FRAMES) high = NUM_RAM_FRAMES;
+    mem_system->watermark_low = low;
+    mem_system->watermark_high = high;
+    if (!KSWAPD) return;
+    
+#ifdef _WIN32
+    printf("⚠️  kswapd no está disponible en Windows. Solo habrá reclamación directa.\n");
+#else
+    pthread_cond_init(&mem_system->kswapd_wait, NULL);
+    mem_system->kswapd_running = true;
+    if (pthread_create(&mem_system->kswapd_thread, NULL, kswapd_main, mem_system) != 0) {
+        printf("⚠️  No se pudo crear el hilo kswapd. Solo habrá reclamación directa.\n");
+        mem_system->kswapd_running = false;
+        pthread_cond_destroy(&mem_system->kswapd_wait);
+    }
+#endif
+}
+
+// Detener kswapd (el llamador no debe tener el cerrojo)
+void kswapd_stop() {
+    if (!mem_system->kswapd_running) return;
+#ifndef _WIN32
+    pthread_mutex_lock(&mem_system->lock);
+    mem_system->kswapd_stopping = true;
+    pthread_cond_signal(&mem_system->kswapd_wait);
+    pthread_mutex_unlock(&mem_system->lock);
+    pthread_join(mem_system->kswapd_thread, NULL);
+    pthread_cond_destroy(&mem_system->kswapd_wait);
+#endif
+    mem_system->kswapd_running = false;
+}
+
+// ==================== CERROJOS ====================
+// Con un solo hilo no se toma ningún cerrojo. Con kswapd o varios núcleos:
+// - lock (recursivo) protege marcos, Swap, política, tablas de páginas y
+//   contadores globales; lo toman los fallos, los recorridos de tabla y la
+//   reclamación
+// - cada núcleo cierra su TLB en los aciertos y quien hace un shootdown
+//   cierra la TLB de los demás; el orden es siempre lock -> TLB
+// - el registro de eventos no usa estos cerrojos (anillo sin cerrojos)
+
+// Crear los cerrojos si el sistema va a tener más de un hilo
+void locking_start() {
+    mem_system->locking = false;
+#ifndef _WIN32
+    if (!KSWAPD && mem_system->num_cores == 1) return;
+    
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&mem_system->lock, &attr);
+    pthread_mutexattr_destroy(&attr);
+    for (int c = 0; c < mem_system->num_cores; c++) {
+        pthread_mutex_init(&mem_system->cores[c].tlb_lock, NULL);
+    }
+    mem_system->locking = true;
+#endif
+}
+
+// Destruir los cerrojos (con todos los hilos ya detenidos)
+void locking_stop() {
+#ifndef _WIN32
+    if (!mem_system->locking) return;
+    pthread_mutex_destroy(&mem_system->lock);
+    for (int c = 0; c < mem_system->num_cores; c++) {
+        pthread_mutex_destroy(&mem_system->cores[c].tlb_lock);
+    }
+#endif
+    mem_system->locking = false;
+}
+
+// Tomar el cerrojo global, contando las veces que hubo que esperarlo
+void mm_lock() {
+#ifndef _WIN32
+    if (!mem_system->locking) return;
+    if (pthread_mutex_trylock(&mem_system->lock) != 0) {
+        pthread_mutex_lock(&mem_system->lock);
+        mem_system->lock_contended++;
+    }
+    mem_system->lock_acquired++;
+#endif
+}
+
+void mm_unlock() {
+#ifndef _WIN32
+    if (mem_system->locking) pthread_mutex_unlock(&mem_system->lock);
+#endif
+}
+
+// Intercambiar página de Swap a RAM (Swap In)
+// Con prefetch = true la página llega por lectura anticipada: no cuenta como
+// fallo, no entra en la TLB y su lectura no bloquea con E/S asíncrona.
+static bool swap_in_page_internal(int pid, int page_number, bool prefetch) {
+    PCB *process = find_process(pid);
+    if (!process) {
+        return false;
+    }
+    
+    if (page_number < 0 || page_number >= process->num_pages) {
+        return false;
+    }
+    
+    PageTableEntry *page_entry = page_table_lookup(process, page_number);
+    
+    if (!page_entry || page_entry->state != PAGE_IN_SWAP) {
+        return false;
+    }
+    
+    int swap_position = page_entry->swap_position;
+    if (swap_position < 0 || swap_position >= NUM_SWAP_FRAMES) {
+        return false;
+    }
+    
+    // Leer la página del dispositivo antes de hacerle espacio en RAM
+    bool read_ok = prefetch ? swap_device_prefetch(swap_position, pid, page_number)
+                            : swap_device_read(swap_position, pid, page_number);
+    if (!read_ok) {
+        LOG_ERROR(EVENT_SWAP_READ_ERROR, .pid = pid, 
+                  .page_number = page_number, .swap_slot = swap_position);
+        return false;
+    }
+    
+    // Buscar marco libre en RAM
+    int ram_frame = find_free_ram_frame();
+    
+    // Si no hay marcos libres, reclamar un lote de víctimas
+    if (ram_frame == -1) {
+        ram_frame = reclaim_ram_frames(pid, page_number);
+        if (ram_frame == -1) {
+            LOG_ERROR(EVENT_NO_FRAME, .pid = pid, .page_number = page_number);
+            return false;
+        }
+    }
+    
+    // Mover página de Swap a RAM
+    occupy_ram_frame(ram_frame, pid, page_number);
+    arena_fill(ram_frame);
     
     // Actualizar tabla de páginas
-    page_entry->state = PAGE_IN_SWAP;
-    page_entry->frame_number = -1;
-    page_entry->swap_position = swap_frame;
-    page_entry->valid = false;
+    page_entry->state = PAGE_IN_RAM;
+    page_entry->frame_number = ram_frame;
+    page_entry->valid = true;
+    page_entry->modified = false;
+    page_entry->prefetched = prefetch;
+    page_table_cold(process, page_entry, page_number)->load_time = sim_tick();
+    
+    // Conservar la ranura en la caché de swap mientras la página siga limpia
+    swap_cache_insert(swap_position);
+    
+    // Actualizar estadísticas
+    // Las páginas anticipadas viajan en el mismo lote que la del fallo y no
+    // suman otra lectura al reloj simulado
+    mem_system->total_swap_reads++;
+    if (prefetch) {
+        mem_system->total_prefetched++;
+        mem_system->swap_last_slot = swap_position;
+    } else {
+        tlb_update(pid, page_number, ram_frame);
+        mem_system->sim_time_ns += COST_SWAP_READ;
+        swap_seek(swap_position);
+        process->page_faults++;
+        mem_system->total_page_faults++;
+    }
+    LOG_DEBUG(prefetch ? EVENT_READAHEAD : EVENT_SWAP_IN, .pid = pid, 
+              .page_number = page_number, .frame = ram_frame, .swap_slot = swap_position);
+    
+    return true;
+}
+
+bool swap_in_page(int pid, int page_number) {
+    return swap_in_page_internal(pid, page_number, false);
+}
+
+// ==================== LECTURA ANTICIPADA ====================
+// Cada PCB lleva un detector de paso. Tras un fallo en un recorrido con paso
+// constante se traen las siguientes ra_window páginas del mismo paso que
+// estén en Swap. La ventana crece en uno por cada prefetch usada (hasta
+// READAHEAD_MAX) y se reduce a la mitad, sin bajar de 1, por cada prefetch
+// expulsada sin usar.
+
+// Actualizar el detector de paso con un acceso (los accesos repetidos a la
+// misma página no cambian el paso)
+void readahead_observe(PCB *process, int page_number) {
+    if (process->ra_last_page == page_number) return;
+    int stride = page_number - process->ra_last_page;
+    if (process->ra_last_page != -1 && stride == process->ra_stride) {
+        process->ra_streak++;
+    } else {
+        process->ra_stride = stride;
+        process->ra_streak = 0;
+    }
+    process->ra_last_page = page_number;
+}
+
+// Traer por adelantado las páginas que siguen a la del fallo
+void readahead_batch(PCB *process, int page_number) {
+    if (READAHEAD_MAX <= 0 || process->ra_streak < 1 || process->ra_window < 1) return;
+    
+    // No desplazar más de la mitad de la RAM en un solo lote
+    int window = process->ra_window;
+    if (window > NUM_RAM_FRAMES / 2) window = NUM_RAM_FRAMES / 2;
+    
+    int loaded = 0;
+    for (int k = 1; k <= window; k++) {
+        long next = (long)page_number + (long)process->ra_stride * k;
+        if (next < 0 || next >= process->num_pages) break;
+        PageTableEntry *entry = page_table_lookup(process, (int)next);
+        if (!entry || entry->state != PAGE_IN_SWAP) continue;
+        if (!swap_in_page_internal(process->pid, (int)next, true)) break;
+        loaded++;
+    }
+    if (loaded > 0) mem_system->total_readahead_batches++;
+}
+
+// Primera vez que se usa una página anticipada: acierto y ventana mayor
+void readahead_hit(PCB *process, PageTableEntry *entry) {
+    entry->prefetched = false;
+    mem_system->total_prefetch_hits++;
+    if (process->ra_window < READAHEAD_MAX) process->ra_window++;
+    
+    // Si la lectura sigue en curso, el acceso espera esa misma petición
+    swap_device_wait(entry->swap_position);
+}
+
+// Página anticipada expulsada sin usarse: desperdicio y ventana menor
+void readahead_wasted(PCB *process, PageTableEntry *entry) {
+    entry->prefetched = false;
+    mem_system->total_prefetch_wasted++;
+    if (process->ra_window > 1) process->ra_window /= 2;
+}
+
+// Marcar una página residente como modificada; su copia en Swap deja de valer.
+// Una página grande tiene un solo bit de modificación: se marcan todas sus
+// páginas y al expulsarla se escriben todas.
+static void mark_page_dirty(PCB *process, PageTableEntry *entry, int page_number) {
+    if (!entry->huge) {
+        entry->modified = true;
+        swap_cache_drop(entry);
+        return;
+    }
+    int span = 1 << HUGE_PAGE_ORDER;
+    int base = page_number & ~(span - 1);
+    for (int k = 0; k < span; k++) {
+        PageTableEntry *page_entry = page_table_lookup(process, base + k);
+        page_entry->modified = true;
+        swap_cache_drop(page_entry);
+    }
+}
+
+// Marco que registra la política: el inicio del bloque en una página grande
+static inline int frame_unit(const PageTableEntry *entry) {
+    return entry->huge ? entry->frame_number & ~((1 << HUGE_PAGE_ORDER) - 1) : entry->frame_number;
+}
+
+// Cargar en la TLB la traducción de una página (una entrada si es grande)
+static void tlb_map(int pid, int page_number, const PageTableEntry *entry) {
+    if (entry->huge) {
+        tlb_update_huge(pid, page_number, entry->frame_number);
+    } else {
+        tlb_update(pid, page_number, entry->frame_number);
+    }
+}
+
+// Primer acceso a una página que nunca se tocó (tabla multinivel): se crea
+// su camino en la tabla y recibe un marco nuevo en cero, sin leer de Swap
+static PageTableEntry* page_zero_fill(PCB *process, int page_number) {
+    PageTableEntry *entry = page_table_materialize(process, page_number);
+    if (!entry) {
+        return NULL;
+    }
+    
+    int frame = allocate_page_in_ram(process->pid, page_number);
+    if (frame == -1) {
+        LOG_ERROR(EVENT_NO_FRAME, .pid = process->pid, .page_number = page_number);
+        return NULL;
+    }
+    if (mem_system->arena) {
+        size_t page_bytes = (size_t)PAGE_SIZE * 1024;
+        memset(mem_system->arena + (size_t)frame * page_bytes, 0, page_bytes);
+        mem_system->arena_bytes_filled += page_bytes;
+    }
+    
+    entry->frame_number = frame;
+    entry->state = PAGE_IN_RAM;
+    entry->valid = true;
+    entry->modified = false;
+    entry->prefetched = false;
+    entry->swap_position = -1;
+    page_table_cold(process, entry, page_number)->load_time = sim_tick();
+    
+    tlb_update(process->pid, page_number, frame);
+    process->page_faults++;
+    mem_system->total_page_faults++;
+    mem_system->total_zero_fills++;
+    
+    LOG_DEBUG(EVENT_ZERO_FILL, .pid = process->pid, .page_number = page_number, .frame = frame);
+    return entry;
+}
+
+// Servir toda la región alineada de page_number con una página grande: un
+// bloque del buddy de 2^HUGE_PAGE_ORDER marcos, las páginas en Swap se leen y
+// las nuevas se crean en cero. Solo se intenta si la región cabe entera en el
+// proceso y ninguna de sus páginas está en RAM. En un fallo (fault) se
+// reclama hasta reunir los marcos; si quedan dispersos no hay bloque, se
+// cuenta el fallback y el llamador sigue con páginas base.
+static bool huge_page_map(PCB *process, int page_number, bool fault) {
+    if (HUGE_PAGE_ORDER == 0) {
+        return false;
+    }
+    int pid = process->pid;
+    int span = 1 << HUGE_PAGE_ORDER;
+    int base = page_number & ~(span - 1);
+    if ((long long)base + span > process->num_pages) {
+        return false;
+    }
+    for (int k = 0; k < span; k++) {
+        const PageTableEntry *entry = page_table_lookup(process, base + k);
+        if (entry && entry->state == PAGE_IN_RAM) return false;
+    }
+    
+    BuddyAllocator *buddy = &mem_system->buddy;
+    int head = buddy_alloc(buddy, HUGE_PAGE_ORDER);
+    if (head == -1 && fault && mem_system->ram_free.free_count < span) {
+        mem_system->total_direct_reclaims++;
+        while (mem_system->ram_free.free_count < span && 
+               reclaim_pass(pid, page_number, reclaim_limit()) > 0) {
+        }
+        head = buddy_alloc(buddy, HUGE_PAGE_ORDER);
+    }
+    if (head == -1) {
+        mem_system->total_huge_fallbacks++;
+        return false;
+    }
+    
+    // Crear las entradas y leer las páginas que estaban en Swap
+    for (int k = 0; k < span; k++) {
+        PageTableEntry *entry = page_table_materialize(process, base + k);
+        bool read_ok = entry != NULL;
+        if (entry && entry->state == PAGE_IN_SWAP) {
+            read_ok = swap_device_read(entry->swap_position, pid, base + k);
+        }
+        if (!read_ok) {
+            LOG_ERROR(EVENT_HUGE_READ_ERROR, .pid = pid, .page_number = base + k);
+            for (int j = 0; j < span; j++) {
+                buddy_free(buddy, head + j);
+            }
+            return false;
+        }
+    }
+    
+    int from_swap = 0;
+    for (int k = 0; k < span; k++) {
+        PageTableEntry *entry = page_table_lookup(process, base + k);
+        int frame = head + k;
+        frame_claim(frame, pid, base + k);
+        
+        if (entry->state == PAGE_IN_SWAP) {
+            arena_fill(frame);
+            swap_cache_insert(entry->swap_position);
+            mem_system->total_swap_reads++;
+            mem_system->sim_time_ns += COST_SWAP_READ;
+            swap_seek(entry->swap_position);
+            from_swap++;
+        } else if (fault) {
+            if (mem_system->arena) {
+                size_t page_bytes = (size_t)PAGE_SIZE * 1024;
+                memset(mem_system->arena + (size_t)frame * page_bytes, 0, page_bytes);
+                mem_system->arena_bytes_filled += page_bytes;
+            }
+            entry->swap_position = -1;
+            mem_system->total_zero_fills++;
+        }
+        
+        entry->frame_number = frame;
+        entry->state = PAGE_IN_RAM;
+        entry->valid = true;
+        entry->modified = false;
+        entry->prefetched = false;
+        entry->huge = true;
+        PageTableCold *cold = page_table_cold(process, entry, base + k);
+        cold->last_access = sim_tick();
+        cold->load_time = sim_tick();
+    }
+    
+    // La política ve la página grande como un solo marco
+    mem_system->policy->on_load(head);
+    kswapd_check_watermark();
+    tlb_update_huge(pid, page_number, head + (page_number - base));
+    mem_system->huge_resident++;
+    mem_system->total_huge_pages++;
+    if (fault) {
+        process->page_faults++;
+        mem_system->total_page_faults++;
+    }
+    
+    LOG_DEBUG(EVENT_HUGE_MAP, .pid = pid, .page_number = base, .frame = head, 
+              .count = span, .value = from_swap);
+    return true;
+}
+
+// Resto de un acceso, con el cerrojo global: primera escritura sobre una
+// página limpia con acierto en la TLB, recorrido de la tabla y fallo
+// (swap in o página nueva en cero)
+static AccessResult access_page_locked(PCB *process, int page_number, bool write, 
+                                       bool tlb_hit, unsigned long long tick) {
+    int pid = process->pid;
+    PageTableEntry *entry = page_table_lookup(process, page_number);
+    
+    // Si otro núcleo expulsó la página entretanto, se sigue como un TLB miss
+    if (tlb_hit && entry && entry->state == PAGE_IN_RAM) {
+        int frame = entry->frame_number;
+        page_table_cold(process, entry, page_number)->last_access = tick;
+        if (write) mark_page_dirty(process, entry, page_number);
+        arena_touch(frame, write);
+        mem_system->sim_time_ns += COST_RAM_ACCESS;
+        if (mem_system->policy->on_access) mem_system->policy->on_access(frame_unit(entry));
+        
+        LOG_TRACE(EVENT_TLB_HIT, .pid = pid, .page_number = page_number, .frame = frame);
+        return ACCESS_TLB_HIT;
+    }
+    
+    // TLB miss: recorrer la tabla de páginas, un acceso por nivel leído. En
+    // la tabla multinivel una página grande termina el recorrido un nivel
+    // antes (su traducción está en el nodo intermedio, como un PMD).
+    int depth;
+    entry = page_table_walk(process, page_number, &depth);
+    if (entry && entry->huge && PAGE_TABLE_LEVELS > 1) depth--;
+    mem_system->sim_time_ns += (unsigned long long)COST_PAGE_WALK * depth;
+    mem_system->total_page_walks++;
+    mem_system->total_walk_levels += depth;
+    
+    if (entry && entry->state == PAGE_IN_RAM) {
+        if (entry->prefetched) readahead_hit(process, entry);
+        tlb_map(pid, page_number, entry);
+        page_table_cold(process, entry, page_number)->last_access = tick;
+        if (write) mark_page_dirty(process, entry, page_number);
+        arena_touch(entry->frame_number, write);
+        mem_system->sim_time_ns += COST_RAM_ACCESS;
+        if (mem_system->policy->on_access) mem_system->policy->on_access(frame_unit(entry));
+        
+        LOG_TRACE(EVENT_PAGE_HIT, .pid = pid, .page_number = page_number, 
+                  .frame = entry->frame_number);
+        return ACCESS_PAGE_HIT;
+    }
+    
+    bool faulted;
+    if (huge_page_map(process, page_number, true)) {
+        entry = page_table_lookup(process, page_number);
+        faulted = true;
+    } else if (!entry || entry->state == PAGE_FREE) {
+        entry = page_zero_fill(process, page_number);
+        faulted = entry != NULL;
+    } else {
+        faulted = entry->state == PAGE_IN_SWAP && swap_in_page(pid, page_number);
+    }
+    
+    if (faulted) {
+        page_table_cold(process, entry, page_number)->last_access = tick;
+        if (write) mark_page_dirty(process, entry, page_number);
+        arena_touch(entry->frame_number, write);
+        mem_system->sim_time_ns += COST_RAM_ACCESS;
+        if (mem_system->policy->on_access) mem_system->policy->on_access(frame_unit(entry));
+        readahead_batch(process, page_number);
+        return ACCESS_PAGE_FAULT;
+    }
+    
+    return ACCESS_ERROR;
+}
+
+// Acceder a una página: TLB -> tabla de páginas -> swap in
+// Una escritura marca la página como modificada (dirty bit).
+// Un acierto en la TLB del núcleo es el camino rápido: solo cierra esa TLB
+// (y el cerrojo global si la política mantiene listas en on_access). Cada
+// proceso se reproduce en un único núcleo, así que su detector de paso y
+// sus marcas de acceso no se comparten entre hilos.
+AccessResult access_page(int pid, int page_number, bool write) {
+    PCB *process = find_process(pid);
+    if (!process || page_number < 0 || page_number >= process->num_pages) {
+        return ACCESS_ERROR;
+    }
+    
+    // Incrementar accesos a memoria y avanzar el reloj lógico
+    Core *core = this_core();
+    core->accesses++;
+    unsigned long long tick = __atomic_add_fetch(&mem_system->tick, 1, __ATOMIC_RELAXED);
+    readahead_observe(process, page_number);
+    
+    PageTableEntry *entry = page_table_lookup(process, page_number);
+    
+    // Buscar en la TLB del núcleo
+    bool shared = mem_system->policy->shared_access;
+    if (shared) mm_lock();
+    core_lock(core);
+    int frame = tlb_lookup(pid, page_number);
+    core->sim_time_ns += COST_TLB_HIT;
+    
+    // La primera escritura sobre una página limpia descarta su copia en Swap
+    // y necesita el cerrojo global
+    if (frame != -1 && entry && (!write || entry->modified)) {
+        page_table_cold(process, entry, page_number)->last_access = tick;
+        arena_touch(frame, write);
+        core->sim_time_ns += COST_RAM_ACCESS;
+        if (mem_system->policy->on_access) mem_system->policy->on_access(frame_unit(entry));
+        core_unlock(core);
+        if (shared) mm_unlock();
+        
+        LOG_TRACE(EVENT_TLB_HIT, .pid = pid, .page_number = page_number, .frame = frame);
+        return ACCESS_TLB_HIT;
+    }
+    core_unlock(core);
+    if (!shared) mm_lock();
+    
+    AccessResult result = access_page_locked(process, page_number, write, frame != -1, tick);
+    mm_unlock();
+    return result;
+}
+
+// Asignar página en RAM
+int allocate_page_in_ram(int pid, int page_number) {
+    // Buscar marco libre
+    int frame_index = find_free_ram_frame();
+    
+    // Si no hay marcos libres, reclamar un lote de víctimas
+    if (frame_index == -1) {
+        frame_index = reclaim_ram_frames(pid, page_number);
+        if (frame_index == -1) {
+            return -1; // No se pudo hacer swap out
+        }
+    }
+    
+    // Asignar marco (la política registra el marco)
+    occupy_ram_frame(frame_index, pid, page_number);
+    
+    return frame_index;
+}
+
+// Crear proceso - CORREGIDO PARA NO HACER SWAP OUT AL CREAR
+int create_process(const char *name, long long size_kb) {
+    if (mem_system->num_processes >= MAX_PROCESSES) {
+        printf("❌ Error: Número máximo de procesos alcanzado.\n");
+        return -1;
+    }
+    
+    if (size_kb <= 0) {
+        printf("❌ Error: Tamaño de proceso inválido.\n");
+        return -1;
+    }
+    
+    // Calcular número de páginas necesarias
+    long long pages = (size_kb + PAGE_SIZE - 1) / PAGE_SIZE; // Redondeo hacia arriba
+    if (pages > INT_MAX) {
+        printf("❌ Error: El proceso supera el máximo de %d páginas.\n", INT_MAX);
+        return -1;
+    }
+    int num_pages = (int)pages;
+    
+    // Verificar si hay suficiente espacio (RAM + Swap)
+    // Las ranuras de la caché de swap cuentan como libres: se pueden recuperar
+    int free_frames = mem_system->ram_free.free_count + mem_system->swap_free.free_count +
+                      mem_system->swap_cache.size;
+    
+    // Con la tabla multinivel las páginas se crean al tocarse: el tamaño
+    // virtual puede superar la RAM y el Swap
+    if (PAGE_TABLE_LEVELS <= 1 && num_pages > free_frames) {
+        printf("❌ Error: No hay suficiente espacio en memoria (RAM + Swap).\n");
+        return -1;
+    }
+    
+    // Buscar slot libre para el proceso
+    int slot = -1;
+    for (int i = 0; i < MAX_PROCESSES; i++) {
+        if (mem_system->processes[i] == NULL) {
+            slot = i;
+            break;
+        }
+    }
+    
+    if (slot == -1) {
+        printf("❌ Error: No hay slots disponibles para procesos.\n");
+        return -1;
+    }
+    
+    // Crear PCB
+    PCB *process = (PCB*)malloc(sizeof(PCB));
+    process->pid = slot + 1; // PID comienza en 1
+    strncpy(process->name, name, sizeof(process->name) - 1);
+    process->name[sizeof(process->name) - 1] = '\0';
+    process->size = size_kb;
+    process->num_pages = num_pages;
+    process->state = PROC_ACTIVE;
+    process->creation_time = time(NULL);
+    process->page_faults = 0;
+    process->ra_last_page = -1;
+    process->ra_stride = 0;
+    process->ra_streak = 0;
+    process->ra_window = READAHEAD_MAX < 2 ? READAHEAD_MAX : 2;
+    
+    // Crear tabla de páginas
+    if (!page_table_init(process)) {
+        printf("❌ Error: No hay memoria para la tabla de páginas.\n");
+        page_table_destroy(process);
+        free(process);
+        return -1;
+    }
+    
+    // LÓGICA CORREGIDA: Asignar páginas SOLO EN MARCOS LIBRES
+    // No hacer swap out de procesos existentes al crear uno nuevo.
+    // Con la tabla multinivel no se asigna nada: cada página se crea en su
+    // primer acceso (fallo con marco en cero).
+    // Con páginas grandes cada región alineada entera va a una página grande
+    // mientras haya un bloque libre.
+    bool sparse = process->pt_root != NULL;
+    int preloaded = sparse ? 0 : num_pages;
+    int pages_in_ram = 0;
+    int huge_span = 1 << HUGE_PAGE_ORDER;
+    for (int i = 0; i < preloaded; i++) {
+        if (HUGE_PAGE_ORDER > 0 && (i & (huge_span - 1)) == 0 && 
+            mem_system->ram_free.free_count >= huge_span && huge_page_map(process, i, false)) {
+            pages_in_ram += huge_span;
+            i += huge_span - 1;
+            continue;
+        }
+        
+        // Verificar si hay marco libre en RAM
+        int frame = find_free_ram_frame();
+        
+        if (frame != -1) {
+            // Asignar directamente en RAM (sin hacer swap out de procesos existentes)
+            occupy_ram_frame(frame, process->pid, i);
+            
+            process->page_table[i].frame_number = frame;
+            process->page_table[i].state = PAGE_IN_RAM;
+            process->page_table[i].valid = true;
+            process->page_table[i].modified = false;
+            process->page_table[i].prefetched = false;
+            process->page_table[i].swap_position = -1;
+            PageTableCold *cold = page_table_cold(process, &process->page_table[i], i);
+            cold->last_access = sim_tick();
+            cold->load_time = sim_tick();
+            
+            // Actualizar TLB
+            tlb_update(process->pid, i, frame);
+            
+            pages_in_ram++;
+        } else {
+            // No hay marcos libres en RAM, asignar directamente en Swap
+            int swap_frame = allocate_swap_slot();
+            if (swap_frame == -1) {
+                // No hay espacio ni en RAM ni en Swap
+                printf("❌ Error: No hay espacio disponible para el proceso.\n");
+                
+                // Liberar páginas ya asignadas
+                for (int j = 0; j < i; j++) {
+                    if (process->page_table[j].state == PAGE_IN_RAM) {
+                        if (process->page_table[j].huge && (j & (huge_span - 1)) == 0) {
+                            mem_system->huge_resident--;
+                        }
+                        swap_cache_drop(&process->page_table[j]);
+                        release_ram_frame(process->page_table[j].frame_number);
+                    } else if (process->page_table[j].state == PAGE_IN_SWAP) {
+                        release_swap_frame(process->page_table[j].swap_position);
+                    }
+                }
+                
+                page_table_destroy(process);
+                free(process);
+                return -1;
+            }
+            
+            // Asignar directamente en Swap (sin hacer swap out)
+            occupy_swap_frame(swap_frame, process->pid, i);
+            
+            process->page_table[i].frame_number = -1;
+            process->page_table[i].state = PAGE_IN_SWAP;
+            process->page_table[i].valid = false;
+            process->page_table[i].modified = false;
+            process->page_table[i].prefetched = false;
+            process->page_table[i].swap_position = swap_frame;
+            page_table_cold(process, &process->page_table[i], i)->load_time = sim_tick();
+        }
+    }
+    
+    // Si todas las páginas están en Swap, o algunas están en Swap, marcar proceso como SWAPPED
+    if (!sparse && (pages_in_ram == 0 || (pages_in_ram > 0 && pages_in_ram < num_pages))) {
+        process->state = PROC_SWAPPED;
+    }
+    
+    // Agregar proceso al sistema
+    mem_system->processes[slot] = process;
+    mem_system->num_processes++;
+    
+    LOG_INFO(sparse ? EVENT_PROCESS_CREATE_LAZY : EVENT_PROCESS_CREATE, .pid = process->pid, 
+             .page_number = num_pages, .frame = pages_in_ram, 
+             .swap_slot = num_pages - pages_in_ram, .value = size_kb);
+    
+    if (quiet_mode) {
+        return process->pid;
+    }
+    
+    printf("\n✓ Proceso creado exitosamente:\n");
+    printf("  PID: %d\n", process->pid);
+    printf("  Nombre: %s\n", process->name);
+    printf("  Tamaño: %lld KB\n", size_kb);
+    printf("  Páginas: %d (Tamaño de página: %d KB)\n", num_pages, PAGE_SIZE);
+    if (sparse) {
+        printf("  Tabla de páginas: %d niveles, %zu bytes (cada página se crea al tocarla)\n", 
+               PAGE_TABLE_LEVELS, process->pt_bytes);
+        return process->pid;
+    }
+    printf("  Páginas en RAM: %d\n", pages_in_ram);
+    printf("  Páginas en Swap: %d\n", num_pages - pages_in_ram);
+    
+    if (pages_in_ram < num_pages) {
+        printf("  ⚠️  Estado: SWAPPED (algunas páginas en swap debido a memoria RAM llena)\n");
+    }
+    
+    return process->pid;
+}
+
+// Terminar proceso
+bool terminate_process(int pid) {
+    PCB *process = find_process(pid);
+    if (!process) {
+        printf("❌ Error: Proceso con PID %d no encontrado.\n", pid);
+        return false;
+    }
+    
+    // Liberar páginas en RAM
+    for (int i = page_table_next(process, 0); i != -1; i = page_table_next(process, i + 1)) {
+        PageTableEntry *entry = page_table_lookup(process, i);
+        if (entry->state == PAGE_IN_RAM) {
+            if (entry->huge && (i & ((1 << HUGE_PAGE_ORDER) - 1)) == 0) {
+                mem_system->huge_resident--;
+            }
+            swap_cache_drop(entry);
+            release_ram_frame(entry->frame_number);
+        } else if (entry->state == PAGE_IN_SWAP) {
+            release_swap_frame(entry->swap_position);
+        }
+    }
+    
+    // Invalidar entradas de TLB
+    tlb_invalidate(pid);
+    
+    // Actualizar estado
+    process->state = PROC_TERMINATED;
+    
+    LOG_INFO(EVENT_PROCESS_EXIT, .pid = process->pid, .value = (long long)process->page_faults);
+    
+    // Buscar slot del proceso
+    for (int i = 0; i < MAX_PROCESSES; i++) {
+        if (mem_system->processes[i] && mem_system->processes[i]->pid == pid) {
+            page_table_destroy(mem_system->processes[i]);
+            free(mem_system->processes[i]);
+            mem_system->processes[i] = NULL;
+            mem_system->num_processes--;
+            break;
+        }
+    }
+    
+    printf("✓ Proceso %d terminado y memoria liberada.\n", pid);
+    return true;
+}
+
+// Mostrar mapa de memoria
+void display_memory_map() {
+    printf("\n╔════════════════════════════════════════════════════════════╗\n");
+    printf("║                    MAPA DE MEMORIA RAM                     ║\n");
+    printf("╚════════════════════════════════════════════════════════════╝\n\n");
+    
+    int free_frames = 0;
+    for (int i = 0; i < NUM_RAM_FRAMES; i++) {
+        if (mem_system->ram_frames.pid[i] != -1) {
+            printf("  [Marco %2d] Proceso %d, Página %d\n", 
+                   i, mem_system->ram_frames.pid[i], mem_system->ram_frames.page_number[i]);
+        } else {
+            printf("  [Marco %2d] [LIBRE]\n", i);
+            free_frames++;
+        }
+    }
+    
+    printf("\n  Total marcos RAM: %d | Libres: %d | Ocupados: %d\n", 
+           NUM_RAM_FRAMES, free_frames, NUM_RAM_FRAMES - free_frames);
+    printf("  Utilización: %.2f%%\n", 
+           ((float)(NUM_RAM_FRAMES - free_frames) / NUM_RAM_FRAMES) * 100);
+    
+    printf("\n╔════════════════════════════════════════════════════════════╗\n");
+    printf("║                   MAPA DE ÁREA DE SWAP                     ║\n");
+    printf("╚════════════════════════════════════════════════════════════╝\n\n");
+    
+    int free_swap = 0;
+    int occupied_swap = 0;
+    
+    for (int i = 0; i < NUM_SWAP_FRAMES; i++) {
+        if (mem_system->swap_frames.pid[i] != -1) {
+            printf("  [Swap %2d] Proceso %d, Página %d%s\n", 
+                   i, mem_system->swap_frames.pid[i], mem_system->swap_frames.page_number[i],
+                   mem_system->swap_cached[i] ? " (caché)" : "");
+            occupied_swap++;
+        } else {
+            free_swap++;
+        }
+    }
+    
+    if (occupied_swap == 0) {
+        printf("  [Área de Swap vacía]\n");
+    }
+    
+    printf("\n  Total marcos Swap: %d | Libres: %d | Ocupados: %d\n", 
+           NUM_SWAP_FRAMES, free_swap, occupied_swap);
+    printf("  Utilización: %.2f%%\n", 
+           ((float)occupied_swap / NUM_SWAP_FRAMES) * 100);
+}
+
+// Mostrar tabla de páginas de un proceso
+void display_process_table(int pid) {
+    PCB *process = find_process(pid);
+    if (!process) {
+        printf("❌ Error: Proceso con PID %d no encontrado.\n", pid);
+        return;
+    }
+    
+    printf("\n╔════════════════════════════════════════════════════════════╗\n");
+    printf("║            TABLA DE PÁGINAS - Proceso %d                    ║\n", pid);
+    printf("╚════════════════════════════════════════════════════════════╝\n\n");
+    
+    printf("  Nombre: %s\n", process->name);
+    printf("  Tamaño: %lld KB\n", process->size);
+    printf("  Número de páginas: %d\n", process->num_pages);
+    printf("  Estado: ");
+    
+    switch (process->state) {
+        case PROC_ACTIVE: printf("ACTIVO\n"); break;
+        case PROC_SUSPENDED: printf("SUSPENDIDO\n"); break;
+        case PROC_SWAPPED: printf("INTERCAMBIADO (parcial)\n"); break;
+        case PROC_TERMINATED: printf("TERMINADO\n"); break;
+    }
+    
+    printf("  Page Faults: %llu\n", process->page_faults);
+    if (process->pt_root) {
+        printf("  Tabla de páginas: %d niveles, %zu bytes (solo se listan las páginas tocadas)\n", 
+               PAGE_TABLE_LEVELS, process->pt_bytes);
+    } else {
+        printf("  Tabla de páginas: densa, %zu bytes\n", process->pt_bytes);
+    }
+    if (HUGE_PAGE_ORDER > 0) {
+        printf("  (G) = parte de una página grande de %d KB\n", HUGE_PAGE_SIZE);
+    }
+    printf("\n");
+    
+    printf("  %-8s %-12s %-12s %-8s %-12s\n", 
+           "Página", "Estado", "Marco RAM", "Válido", "Swap Pos");
+    printf("  %s\n", "----------------------------------------------------------------");
+    
+    for (int i = page_table_next(process, 0); i != -1; i = page_table_next(process, i + 1)) {
+        PageTableEntry *entry = page_table_lookup(process, i);
+        
+        printf("  %-8d ", i);
+        
+        switch (entry->state) {
+            case PAGE_IN_RAM:
+                printf("%-12s %-12d %-8s %-12s\n", 
+                       entry->huge ? "EN RAM (G)" : "EN RAM", entry->frame_number, 
+                       entry->valid ? "Sí" : "No", "-");
+                break;
+            case PAGE_IN_SWAP:
+                printf("%-12s %-12s %-8s %-12d\n", 
+                       "EN SWAP", "-", "No", entry->swap_position);
+                break;
+            default:
+                printf("%-12s %-12s %-8s %-12s\n", 
+                       "LIBRE", "-", "No", "-");
+                break;
+        }
+    }
+}
+
+// Mostrar estado del sistema
+void display_system_status() {
+    printf("\n╔════════════════════════════════════════════════════════════╗\n");
+    printf("║                   ESTADO DEL SISTEMA                       ║\n");
+    printf("╚════════════════════════════════════════════════════════════╝\n\n");
+    
+    printf("  PROCESOS ACTIVOS: %d\n\n", mem_system->num_processes);
+    
+    if (mem_system->num_processes == 0) {
+        printf("  [No hay procesos activos]\n");
+    } else {
+        printf("  %-6s %-20s %-12s %-10s %-15s\n", 
+               "PID", "Nombre", "Tamaño", "Páginas", "Estado");
+        printf("  %s\n", "------------------------------------------------------------------------");
+        
+        for (int i = 0; i < MAX_PROCESSES; i++) {
+            PCB *p = mem_system->processes[i];
+            if (p) {
+                printf("  %-6d %-20s %-12lld %-10d ", 
+                       p->pid, p->name, p->size, p->num_pages);
+                
+                switch (p->state) {
+                    case PROC_ACTIVE: printf("%-15s\n", "ACTIVO"); break;
+                    case PROC_SUSPENDED: printf("%-15s\n", "SUSPENDIDO"); break;
+                    case PROC_SWAPPED: printf("%-15s\n", "INTERCAMBIADO"); break;
+                    case PROC_TERMINATED: printf("%-15s\n", "TERMINADO"); break;
+                }
+            }
+        }
+    }
+    
+    // Resumen de memoria
+    int ram_used = NUM_RAM_FRAMES - mem_system->ram_free.free_count;
+    int swap_used = NUM_SWAP_FRAMES - mem_system->swap_free.free_count;
+    
+    printf("\n  MEMORIA:\n");
+    printf("  RAM: %d/%d marcos ocupados (%.1f%%)\n", 
+           ram_used, NUM_RAM_FRAMES, 
+           ((float)ram_used / NUM_RAM_FRAMES) * 100);
+    printf("  Swap: %d/%d marcos ocupados (%.1f%%)\n", 
+           swap_used, NUM_SWAP_FRAMES, 
+           ((float)swap_used / NUM_SWAP_FRAMES) * 100);
+}
+
+// Mostrar TLB
+void display_tlb() {
+    printf("\n╔════════════════════════════════════════════════════════════╗\n");
+    printf("║           TLB (Translation Lookaside Buffer)              ║\n");
+    printf("╚════════════════════════════════════════════════════════════╝\n\n");
+    
+    printf("  Tamaño de TLB: %d entradas (%d conjuntos de %d vías)\n\n", 
+           TLB_SIZE, TLB_SETS, TLB_WAYS);
+    
+    cores_fold_stats();
+    for (int c = 0; c < mem_system->num_cores; c++) {
+        if (mem_system->num_cores > 1) printf("  Núcleo %d:\n", c);
+        printf("  %-10s %-10s %-8s %-12s %-12s %-10s\n", 
+               "Entrada", "Conjunto", "PID", "Página", "Marco RAM", "Válido");
+        printf("  %s\n", "----------------------------------------------------------------------");
+        
+        for (int i = 0; i < TLB_SIZE; i++) {
+            TLBEntry *entry = &mem_system->cores[c].tlb[i];
+            
+            printf("  %-10d %-10d ", i, i / TLB_WAYS);
+            
+            if (entry->valid) {
+                char page[24];
+                if (entry->huge) {
+                    snprintf(page, sizeof(page), "%d-%d", entry->page_number, 
+                             entry->page_number + (1 << HUGE_PAGE_ORDER) - 1);
+                } else {
+                    snprintf(page, sizeof(page), "%d", entry->page_number);
+                }
+                printf("%-8d %-12s %-12d %-10s\n", 
+                       entry->pid, page, 
+                       entry->frame_number, "Sí");
+            } else {
+                printf("%-8s %-12s %-12s %-10s\n", 
+                       "-", "-", "-", "No");
+            }
+        }
+        printf("\n");
+    }
+    
+    printf("\n  Estadísticas TLB:\n");
+    printf("  Aciertos (hits): %llu\n", mem_system->total_tlb_hits);
+    printf("  Fallos (misses): %llu\n", mem_system->total_tlb_misses);
+    printf("  Shootdowns de página: %llu\n", mem_system->total_tlb_shootdowns);
+    
+    unsigned long long total_accesses = mem_system->total_tlb_hits + mem_system->total_tlb_misses;
+    if (total_accesses > 0) {
+        printf("  Tasa de aciertos: %.2f%%\n", 
+               ((float)mem_system->total_tlb_hits / total_accesses) * 100);
+    }
+}
+
+// Mostrar estadísticas del sistema
+void display_statistics() {
+    printf("\n╔════════════════════════════════════════════════════════════╗\n");
+    printf("║                ESTADÍSTICAS DEL SISTEMA                    ║\n");
+    printf("╚════════════════════════════════════════════════════════════╝\n\n");
     
-    // Liberar marco en RAM
-    ram_frame->pid = -1;
-    ram_frame->page_number = -1;
-    ram_frame->occupied = false;
+    cores_fold_stats();
+    unsigned long long sim_time_ns = sim_time_total();
+    
+    // Calcular fragmentación interna
+    int internal_fragmentation = 0;
+    for (int i = 0; i < MAX_PROCESSES; i++) {
+        PCB *p = mem_system->processes[i];
+        if (p) {
+            int wasted = (int)((long long)p->num_pages * PAGE_SIZE - p->size);
+            internal_fragmentation += wasted;
+        }
+    }
     
-    // Invalidar entrada en TLB
-    tlb_invalidate(process->pid);
+    // Calcular utilización de memoria
+    int ram_used = NUM_RAM_FRAMES - mem_system->ram_free.free_count;
+    int swap_used = NUM_SWAP_FRAMES - mem_system->swap_free.free_count;
     
-    // Actualizar estadísticas
-    mem_system->total_swaps++;
+    float ram_utilization = ((float)ram_used / NUM_RAM_FRAMES) * 100;
+    float swap_utilization = ((float)swap_used / NUM_SWAP_FRAMES) * 100;
     
-    char msg[256];
-    snprintf(msg, sizeof(msg), "SWAP OUT: Proceso %d, Página %d movida de RAM[%d] a Swap[%d]", 
-             process->pid, page_number, frame_index, swap_frame);
-    add_log(msg);
+    // Tiempo promedio de acceso medido con el reloj simulado (modelo de costos)
+    unsigned long long tlb_accesses = mem_system->total_tlb_hits + mem_system->total_tlb_misses;
+    double avg_access_time = 0;
     
-    return true;
+    if (mem_system->total_memory_accesses > 0) {
+        avg_access_time = (double)sim_time_ns / mem_system->total_memory_accesses;
+    }
+    
+    printf("  MÉTRICAS DE RENDIMIENTO:\n\n");
+    
+    printf("  %-40s %s\n", "Política de reemplazo:", mem_system->policy->name);
+    
+    printf("  %-40s %llu\n", "Total de fallos de página:", mem_system->total_page_faults);
+    printf("  %-40s %llu\n", "Lecturas de swap (swap in):", mem_system->total_swap_reads);
+    printf("  %-40s %llu\n", "Escrituras de swap (swap out):", mem_system->total_swap_writes);
+    printf("  %-40s %llu\n", "Expulsiones limpias (sin escritura):", 
+           mem_system->total_clean_evictions);
+    if (opt_baseline.valid) {
+        printf("  %-40s %llu\n", "Fallos de página con OPT (cota):", opt_baseline.page_faults);
+        printf("  %-40s %llu / %llu\n", "Lecturas / escrituras con OPT (cota):", 
+               opt_baseline.swap_reads, opt_baseline.swap_writes);
+        if (opt_baseline.page_faults > 0) {
+            printf("  %-40s %.2fx\n", "Fallos respecto a OPT:", 
+                   (double)mem_system->total_page_faults / opt_baseline.page_faults);
+        }
+    }
+    if (strcmp(mem_system->policy->name, "ARC") == 0) {
+        const ArcState *arc = &mem_system->repl.arc;
+        printf("  %-40s %d de %d marcos\n", "Objetivo adaptativo p (ARC):", arc->p, arc->capacity);
+        printf("  %-40s %d - %d\n", "Rango de p:", arc->p_min, arc->p_max);
+        printf("  %-40s %d / %d / %d / %d\n", "Tamaño de T1 / T2 / B1 / B2:", 
+               arc->t1.size, arc->t2.size, arc->b1.size, arc->b2.size);
+        printf("  %-40s %llu / %llu\n", "Aciertos en fantasmas B1 / B2:", 
+               arc->b1_hits, arc->b2_hits);
+        printf("  Evolución de p (tick: p):\n");
+        for (int i = 0; i < arc->history_count; i++) {
+            printf("%s%llu: %d", i % 4 == 0 ? "    " : ", ", 
+                   arc->history[i].tick, arc->history[i].p);
+            if (i % 4 == 3 || i == arc->history_count - 1) printf("\n");
+        }
+    }
+    printf("  %-40s %.2f ns\n", "Tiempo promedio de acceso:", avg_access_time);
+    printf("  %-40s %llu ns\n", "Tiempo simulado total:", sim_time_ns);
+    printf("  %-40s %llu\n", "Ticks lógicos:", sim_tick());
+    printf("  %-40s %d KB\n", "Fragmentación interna:", internal_fragmentation);
+    
+    printf("\n  UTILIZACIÓN DE MEMORIA:\n\n");
+    printf("  %-40s %.2f%%\n", "Utilización de RAM:", ram_utilization);
+    printf("  %-40s %.2f%%\n", "Utilización de Swap:", swap_utilization);
+    
+    if (mem_system->arena) {
+        printf("\n  ARENA DE RAM (%s):\n\n", mem_system->arena_pages);
+        printf("  %-40s %zu KB\n", "Tamaño de la arena:", mem_system->arena_size / 1024);
+        printf("  %-40s %llu\n", "Bytes tocados por accesos:", mem_system->arena_bytes_touched);
+        printf("  %-40s %llu\n", "Bytes copiados en swap in:", mem_system->arena_bytes_filled);
+    }
+    
+    const SwapDevice *dev = &mem_system->swap_dev;
+    if (dev->fd != -1) {
+        printf("\n  ARCHIVO DE SWAP (%s):\n\n", dev->direct ? "O_DIRECT" : "con caché del SO");
+        printf("  %-40s %s\n", "Archivo:", SWAP_FILE);
+        printf("  %-40s %llu / %llu\n", "Lecturas / escrituras reales:", dev->reads, dev->writes);
+        if (dev->reads > 0) {
+            printf("  %-40s %.2f us (máx. %.2f us, modelo %.2f us)\n", "Latencia de lectura:", 
+                   dev->read_ns / 1000.0 / dev->reads, dev->read_ns_max / 1000.0, 
+                   COST_SWAP_READ / 1000.0);
+        }
+        if (dev->writes > 0) {
+            printf("  %-40s %.2f us (máx. %.2f us, modelo %.2f us)\n", "Latencia de escritura:", 
+                   dev->write_ns / 1000.0 / dev->writes, dev->write_ns_max / 1000.0, 
+                   COST_SWAP_WRITE / 1000.0);
+        }
+        printf("  %-40s %s\n", "E/S:", swap_io_backend_name(dev->backend));
+        if (dev->submitted > 0) {
+            printf("  %-40s %.2f (máx. %d)\n", "Profundidad de cola media:", 
+                   (double)dev->depth_sum / dev->submitted, dev->depth_max);
+        }
+        double io_seconds = (double)(dev->last_complete.tv_sec - dev->first_submit.tv_sec) + 
+                            (double)(dev->last_complete.tv_nsec - dev->first_submit.tv_nsec) / 1e9;
+        if (io_seconds > 0) {
+            printf("  %-40s %.0f\n", "IOPS logradas:", (dev->reads + dev->writes) / io_seconds);
+        }
+        if (dev->backend != SWAP_BACKEND_SYNC) {
+            printf("  %-40s %llu\n", "Esperas sobre lecturas en curso:", dev->joins);
+            printf("  %-40s %llu\n", "Lecturas desde escrituras en curso:", dev->forwarded);
+            printf("  %-40s %llu\n", "Ranuras retenidas por E/S en curso:", dev->deferred_releases);
+        }
+        printf("  %-40s %llu\n", "Errores de E/S:", dev->errors);
+        printf("  %-40s %llu\n", "Páginas con sello incorrecto:", dev->mismatches);
+    }
+    
+    if (READAHEAD_MAX > 0) {
+        printf("\n  LECTURA ANTICIPADA (máx. %d páginas):\n\n", READAHEAD_MAX);
+        printf("  %-40s %llu\n", "Lotes de lectura anticipada:", mem_system->total_readahead_batches);
+        printf("  %-40s %llu\n", "Páginas traídas por adelantado:", mem_system->total_prefetched);
+        printf("  %-40s %llu\n", "Prefetch usadas (aciertos):", mem_system->total_prefetch_hits);
+        printf("  %-40s %llu\n", "Prefetch expulsadas sin usar:", mem_system->total_prefetch_wasted);
+    }
+    
+    printf("\n  RECLAMACIÓN Y AGRUPACIÓN EN SWAP:\n\n");
+    printf("  %-40s %llu\n", "Pasadas de reclamación:", mem_system->total_reclaim_passes);
+    if (mem_system->total_reclaim_passes > 0) {
+        printf("  %-40s %.2f\n", "Marcos liberados por pasada:", 
+               (double)mem_system->total_reclaimed / mem_system->total_reclaim_passes);
+    }
+    printf("  %-40s %llu\n", "Reclamaciones directas (en el fallo):", 
+           mem_system->total_direct_reclaims);
+    if (mem_system->total_page_faults > 0) {
+        printf("  %-40s %.2f%%\n", "Fallos con reclamación directa:", 
+               (double)mem_system->total_direct_reclaims * 100 / mem_system->total_page_faults);
+    }
+    if (KSWAPD) {
+        printf("  %-40s %d / %d marcos libres\n", "Marcas de kswapd (baja / alta):", 
+               mem_system->watermark_low, mem_system->watermark_high);
+        printf("  %-40s %llu\n", "Despertares de kswapd:", mem_system->total_kswapd_wakeups);
+        printf("  %-40s %llu\n", "Reclamaciones en segundo plano:", 
+               mem_system->total_kswapd_reclaims);
+        printf("  %-40s %llu\n", "Marcos liberados por kswapd:", 
+               mem_system->total_kswapd_reclaimed);
+        printf("  %-40s %llu ns\n", "Tiempo de E/S de kswapd (fuera):", mem_system->kswapd_ns);
+    }
+    printf("  %-40s %llu\n", "Rachas de escritura contiguas:", mem_system->total_write_clusters);
+    if (mem_system->total_write_clusters > 0) {
+        printf("  %-40s %.2f páginas\n", "Tamaño medio de racha:", 
+               (double)mem_system->total_swap_writes / mem_system->total_write_clusters);
+    }
+    printf("  %-40s %llu\n", "Posicionamientos del cabezal:", mem_system->total_swap_seeks);
+    
+    printf("\n  CACHÉ DE SWAP:\n\n");
+    unsigned long long cache_lookups = mem_system->total_swap_cache_hits + 
+                                       mem_system->total_swap_cache_misses;
+    printf("  %-40s %d\n", "Ranuras en caché:", mem_system->swap_cache.size);
+    printf("  %-40s %llu\n", "Aciertos (expulsión sin escritura):", mem_system->total_swap_cache_hits);
+    printf("  %-40s %llu\n", "Fallos (expulsión con escritura):", mem_system->total_swap_cache_misses);
+    printf("  %-40s %llu\n", "Ranuras recuperadas:", mem_system->total_swap_cache_reclaims);
+    if (cache_lookups > 0) {
+        printf("  %-40s %.2f%%\n", "Tasa de aciertos de la caché:", 
+               (double)mem_system->total_swap_cache_hits / cache_lookups * 100);
+    }
+    
+    printf("\n  TLB:\n\n");
+    printf("  %-40s %llu\n", "Aciertos en TLB:", mem_system->total_tlb_hits);
+    printf("  %-40s %llu\n", "Fallos en TLB:", mem_system->total_tlb_misses);
+    printf("  %-40s %llu\n", "Invalidaciones de página (shootdowns):", 
+           mem_system->total_tlb_shootdowns);
+    
+    if (tlb_accesses > 0) {
+        printf("  %-40s %.2f%%\n", "Tasa de aciertos en TLB:", 
+               ((float)mem_system->total_tlb_hits / tlb_accesses) * 100);
+    }
+    
+    // Alcance: memoria que traducen las entradas válidas (media por núcleo)
+    unsigned long long reach_kb = 0;
+    for (int c = 0; c < mem_system->num_cores; c++) {
+        for (int i = 0; i < TLB_SIZE; i++) {
+            const TLBEntry *entry = &mem_system->cores[c].tlb[i];
+            if (entry->valid) reach_kb += entry->huge ? HUGE_PAGE_SIZE : PAGE_SIZE;
+        }
+    }
+    printf("  %-40s %llu KB (máximo %llu KB)\n", "Alcance de la TLB:", 
+           reach_kb / mem_system->num_cores, 
+           (unsigned long long)TLB_SIZE * (HUGE_PAGE_ORDER > 0 ? HUGE_PAGE_SIZE : PAGE_SIZE));
+    if (HUGE_PAGE_ORDER > 0) {
+        printf("  %-40s %llu KB\n", "Alcance solo con páginas base:", 
+               (unsigned long long)TLB_SIZE * PAGE_SIZE);
+        printf("  %-40s %llu\n", "Aciertos en entradas de páginas grandes:", 
+               mem_system->total_tlb_huge_hits);
+    }
+    
+    if (mem_system->num_cores > 1) {
+        printf("\n  NÚCLEOS (%d, una TLB por núcleo):\n\n", mem_system->num_cores);
+        printf("  %-8s %-14s %-14s %-12s %-12s\n", 
+               "Núcleo", "Accesos", "Aciertos TLB", "Tasa", "Shootdowns");
+        for (int c = 0; c < mem_system->num_cores; c++) {
+            const Core *core = &mem_system->cores[c];
+            unsigned long long lookups = core->tlb_hits + core->tlb_misses;
+            char rate[16];
+            snprintf(rate, sizeof(rate), "%.2f%%", 
+                     lookups > 0 ? (double)core->tlb_hits * 100 / lookups : 0.0);
+            printf("  %-8d %-14llu %-14llu %-12s %-12llu\n", c, core->accesses, 
+                   core->tlb_hits, rate, core->shootdowns);
+        }
+        printf("\n  %-40s %llu\n", "Shootdowns entre núcleos (IPI):", mem_system->total_tlb_ipis);
+        printf("  %-40s %llu\n", "Cerrojo global tomado:", mem_system->lock_acquired);
+        if (mem_system->lock_acquired > 0) {
+            printf("  %-40s %llu (%.2f%%)\n", "Esperas por el cerrojo global:", 
+                   mem_system->lock_contended, 
+                   (double)mem_system->lock_contended * 100 / mem_system->lock_acquired);
+        }
+    }
+    
+    printf("\n  TABLAS DE PÁGINAS:\n\n");
+    unsigned long long virtual_pages = 0;
+    for (int i = 0; i < MAX_PROCESSES; i++) {
+        if (mem_system->processes[i]) virtual_pages += mem_system->processes[i]->num_pages;
+    }
+    if (PAGE_TABLE_LEVELS > 1) {
+        printf("  %-40s %d (%d entradas por nodo)\n", "Niveles:", PAGE_TABLE_LEVELS, PT_LEVEL_ENTRIES);
+    } else {
+        printf("  %-40s %s\n", "Niveles:", "1 (tabla densa)");
+    }
+    printf("  %-40s %llu KB\n", "Memoria de las tablas:", mem_system->page_table_bytes / 1024);
+    printf("  %-40s %llu KB\n", "Máximo de memoria de las tablas:", mem_system->page_table_peak / 1024);
+    if (virtual_pages > 0) {
+        printf("  %-40s %.2f\n", "Bytes de tabla por página virtual:", 
+               (double)mem_system->page_table_bytes / virtual_pages);
+    }
+    printf("  %-40s %llu\n", "Recorridos de la tabla:", mem_system->total_page_walks);
+    if (mem_system->total_page_walks > 0) {
+        printf("  %-40s %.2f (%.0f ns por recorrido)\n", "Niveles leídos por recorrido:", 
+               (double)mem_system->total_walk_levels / mem_system->total_page_walks,
+               (double)mem_system->total_walk_levels * COST_PAGE_WALK / mem_system->total_page_walks);
+    }
+    if (PAGE_TABLE_LEVELS > 1) {
+        printf("  %-40s %llu\n", "Páginas creadas en su primer acceso:", mem_system->total_zero_fills);
+    }
+    
+    if (HUGE_PAGE_ORDER > 0) {
+        const BuddyAllocator *buddy = &mem_system->buddy;
+        int huge_frames = 1 << HUGE_PAGE_ORDER;
+        int free_frames = mem_system->ram_free.free_count;
+        int free_blocks = buddy->free[HUGE_PAGE_ORDER].size;
+        
+        printf("\n  PÁGINAS GRANDES:\n\n");
+        printf("  %-40s %d KB (%d marcos)\n", "Tamaño de página grande:", HUGE_PAGE_SIZE, huge_frames);
+        printf("  %-40s %llu\n", "Páginas grandes creadas:", mem_system->total_huge_pages);
+        printf("  %-40s %d (%.2f%% de la RAM)\n", "Páginas grandes en RAM:", mem_system->huge_resident, 
+               (double)mem_system->huge_resident * huge_frames * 100 / NUM_RAM_FRAMES);
+        printf("  %-40s %llu\n", "Sin bloque contiguo (páginas base):", mem_system->total_huge_fallbacks);
+        printf("  %-40s %llu\n", "Expulsadas enteras:", mem_system->total_huge_evictions);
+        printf("  %-40s %d\n", "Bloques libres de página grande:", free_blocks);
+        if (free_frames > 0) {
+            // Marcos libres que no forman un bloque entero (fragmentación externa)
+            printf("  %-40s %.2f%%\n", "Marcos libres fuera de bloques grandes:", 
+                   (double)(free_frames - free_blocks * huge_frames) * 100 / free_frames);
+        }
+    }
+    
+    const EventLog *events = &mem_system->events;
+    printf("\n  REGISTRO DE EVENTOS:\n\n");
+    if (log_level_parse(LOG_LEVEL) > LOG_COMPILE_LEVEL) {
+        printf("  %-40s %s (compilado hasta %s)\n", "Nivel del registro:", LOG_LEVEL, 
+               LOG_LEVEL_NAMES[LOG_COMPILE_LEVEL]);
+    } else {
+        printf("  %-40s %s\n", "Nivel del registro:", LOG_LEVEL);
+    }
+    printf("  %-41s %s\n", "Categorías registradas:", LOG_CATEGORIES);
+    printf("  %-40s %llu\n", "Eventos registrados:", 
+           (unsigned long long)__atomic_load_n(&events->head, __ATOMIC_RELAXED));
+    printf("  %-40s %llu (anillo de %d)\n", "Eventos descartados (anillo lleno):", 
+           (unsigned long long)__atomic_load_n(&events->overflow, __ATOMIC_RELAXED), LOG_RING_SIZE);
+    if (!events->file) {
+        printf("  %-40s %s\n", "Archivo de eventos:", "ninguno (solo el anillo)");
+    } else {
+        printf("  %-40s %s\n", "Archivo de eventos:", events->temporary ? "temporal" : LOG_FILE);
+    }
+    
+    printf("\n  PROCESOS:\n\n");
+    printf("  %-40s %d\n", "Procesos activos:", mem_system->num_processes);
+    
+    // Tiempo de ejecución
+    time_t current_time = time(NULL);
+    int runtime = (int)difftime(current_time, mem_system->start_time);
+    printf("  %-40s %d segundos\n", "Tiempo de ejecución:", runtime);
 }
 
-// Intercambiar página de Swap a RAM (Swap In)
-bool swap_in_page(int pid, int page_number) {
-    PCB *process = find_process(pid);
-    if (!process) {
+// Mostrar logs
+void display_logs(int count) {
+    printf("\n╔════════════════════════════════════════════════════════════╗\n");
+    printf("║                    REGISTRO DE EVENTOS                     ║\n");
+    printf("╚════════════════════════════════════════════════════════════╝\n\n");
+    
+    EventLog *events = &mem_system->events;
+    events_lock(events);
+    uint64_t total = events_readable(events);
+    if (total == 0) {
+        events_unlock(events);
+        printf("  [No hay eventos registrados]\n");
+        return;
+    }
+    
+    // count <= 0 = todos
+    uint64_t start = (count <= 0 || (uint64_t)count > total) ? 0 : total - count;
+    
+    printf("  Mostrando últimos %llu eventos:\n\n", (unsigned long long)(total - start));
+    
+    for (uint64_t i = start; i < total; i++) {
+        LogEvent event;
+        if (!events_read(events, i, &event)) break;
+        char msg[256];
+        log_format(&event, msg, sizeof(msg));
+        time_t timestamp = mem_system->start_time + event.seconds;
+        struct tm *timeinfo = localtime(&timestamp);
+        
+        printf("  [%02d:%02d:%02d] %s\n", 
+               timeinfo->tm_hour, timeinfo->tm_min, timeinfo->tm_sec,
+               msg);
+    }
+    events_unlock(events);
+    
+    unsigned long long lost = __atomic_load_n(&events->overflow, __ATOMIC_RELAXED);
+    if (lost > 0) {
+        printf("\n  ⚠️  %llu eventos descartados con el anillo lleno.\n", lost);
+    }
+}
+
+// Guardar logs en archivo
+void save_logs_to_file(const char *filename) {
+    FILE *file = fopen(filename, "w");
+    if (!file) {
+        printf("❌ Error: No se pudo crear el archivo de logs.\n");
+        return;
+    }
+    
+    fprintf(file, "========================================\n");
+    fprintf(file, "REGISTRO DE EVENTOS DEL SIMULADOR\n");
+    fprintf(file, "========================================\n\n");
+    
+    EventLog *events = &mem_system->events;
+    events_lock(events);
+    uint64_t total = events_readable(events);
+    for (uint64_t i = 0; i < total; i++) {
+        LogEvent event;
+        if (!events_read(events, i, &event)) break;
+        char msg[256];
+        log_format(&event, msg, sizeof(msg));
+        time_t timestamp = mem_system->start_time + event.seconds;
+        struct tm *timeinfo = localtime(&timestamp);
+        
+        fprintf(file, "[%02d:%02d:%02d] %s\n", 
+                timeinfo->tm_hour, timeinfo->tm_min, timeinfo->tm_sec,
+                msg);
+    }
+    events_unlock(events);
+    
+    unsigned long long lost = __atomic_load_n(&events->overflow, __ATOMIC_RELAXED);
+    if (lost > 0) {
+        fprintf(file, "\n[%llu eventos descartados con el anillo lleno]\n", lost);
+    }
+    
+    fclose(file);
+    printf("✓ Logs guardados en: %s\n", filename);
+}
+
+// ==================== REPRODUCCIÓN DE TRAZAS ====================
+
+// Interpretar una línea de traza "pid página [r|w]"
+// Retorna 1 si es un registro, 0 si es comentario/vacía, -1 si es inválida
+int parse_trace_line(const char *line, TraceRecord *record) {
+    const char *p = line;
+    while (isspace((unsigned char)*p)) p++;
+    if (*p == '\0' || *p == '#') return 0;
+    
+    char *end;
+    long pid = strtol(p, &end, 10);
+    if (end == p) return -1;
+    p = end;
+    
+    long page = strtol(p, &end, 10);
+    if (end == p) return -1;
+    p = end;
+    
+    while (isspace((unsigned char)*p)) p++;
+    char op = 'r';
+    if (*p == 'r' || *p == 'R' || *p == 'w' || *p == 'W') {
+        op = (char)tolower((unsigned char)*p);
+        p++;
+    }
+    while (isspace((unsigned char)*p)) p++;
+    if (*p != '\0' && *p != '#') return -1;
+    
+    if (pid < 1 || pid > MAX_PROCESSES || page < 0 || page > 0x7fffffffL) return -1;
+    
+    record->pid = (int)pid;
+    record->page_number = (int)page;
+    record->op = op;
+    return 1;
+}
+
+// Avanzar la ventana de lectura anticipada de la traza mapeada:
+// se pide al kernel la siguiente ventana y se descarta la ya consumida,
+// de modo que trazas de varios GB no quedan residentes en memoria.
+static void trace_advance_window(TraceReader *reader) {
+#ifndef _WIN32
+    size_t window_records = TRACE_WINDOW_BYTES / sizeof(TraceFileRecord);
+    size_t base = (size_t)((const unsigned char *)reader->records - reader->map);
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    
+    // Descartar la ventana anterior (alineada a página); un mapeo compartido
+    // lo siguen leyendo otros cursores y se conserva
+    if (reader->position >= window_records && !reader->shared) {
+        size_t done = base + (size_t)(reader->position - window_records) * sizeof(TraceFileRecord);
+        done -= done % page;
+        if (done > 0) {
+            madvise(reader->map, done, MADV_DONTNEED);
+        }
+    }
+    
+    // Lectura anticipada de la siguiente ventana
+    uint64_t next_end = reader->position + window_records;
+    if (next_end > reader->header->record_count) {
+        next_end = reader->header->record_count;
+    }
+    size_t from = base + (size_t)reader->window_end * sizeof(TraceFileRecord);
+    size_t to = base + (size_t)next_end * sizeof(TraceFileRecord);
+    from -= from % page;
+    if (to > from) {
+        madvise(reader->map + from, to - from, MADV_WILLNEED);
+    }
+    reader->window_end = next_end;
+#else
+    reader->window_end = reader->header->record_count;
+#endif
+}
+
+// Abrir una traza detectando el formato por la cabecera
+bool trace_open(TraceReader *reader, const char *filename) {
+    memset(reader, 0, sizeof(*reader));
+    reader->filename = filename;
+    
+    FILE *file = fopen(filename, "rb");
+    if (!file) {
+        printf("❌ Error: No se pudo abrir la traza '%s'.\n", filename);
         return false;
     }
     
-    if (page_number < 0 || page_number >= process->num_pages) {
+    char magic[8];
+    bool binary = fread(magic, 1, sizeof(magic), file) == sizeof(magic) &&
+                  memcmp(magic, TRACE_MAGIC, sizeof(magic)) == 0;
+    
+    if (!binary) {
+        rewind(file);
+        reader->file = file;
+        return true;
+    }
+    fclose(file);
+    
+#ifndef _WIN32
+    int fd = open(filename, O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        printf("❌ Error: No se pudo abrir la traza '%s'.\n", filename);
+        if (fd >= 0) close(fd);
         return false;
     }
     
-    PageTableEntry *page_entry = &process->page_table[page_number];
+    reader->map_size = (size_t)st.st_size;
+    if (reader->map_size < sizeof(TraceFileHeader)) {
+        printf("❌ Error: Traza binaria '%s' truncada.\n", filename);
+        close(fd);
+        return false;
+    }
     
-    if (page_entry->state != PAGE_IN_SWAP) {
+    void *map = mmap(NULL, reader->map_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // El mapeo sigue siendo válido
+    if (map == MAP_FAILED) {
+        printf("❌ Error: No se pudo mapear la traza '%s'.\n", filename);
         return false;
     }
+    reader->map = (unsigned char *)map;
+    madvise(reader->map, reader->map_size, MADV_SEQUENTIAL);
     
-    int swap_position = page_entry->swap_position;
-    if (swap_position < 0 || swap_position >= NUM_SWAP_FRAMES) {
+    reader->header = (const TraceFileHeader *)reader->map;
+    size_t records_offset = sizeof(TraceFileHeader) + 
+                            reader->header->num_processes * sizeof(TraceFileProcess);
+    
+    if (reader->header->version != TRACE_VERSION ||
+        reader->header->record_size != sizeof(TraceFileRecord) ||
+        records_offset > reader->map_size ||
+        reader->header->record_count > (reader->map_size - records_offset) / sizeof(TraceFileRecord)) {
+        printf("❌ Error: Traza binaria '%s' inválida o truncada.\n", filename);
+        munmap(reader->map, reader->map_size);
+        reader->map = NULL;
         return false;
     }
     
-    // Buscar marco libre en RAM
-    int ram_frame = find_free_ram_frame();
+    reader->binary = true;
+    reader->process_table = (const TraceFileProcess *)(reader->map + sizeof(TraceFileHeader));
+    reader->records = (const TraceFileRecord *)(reader->map + records_offset);
+    trace_advance_window(reader);
+    return true;
+#else
+    printf("❌ Error: Las trazas binarias no están soportadas en Windows.\n");
+    return false;
+#endif
+}
+
+// Leer el siguiente registro
+// Retorna 1 si hay registro, 0 al final de la traza, -1 si es inválido
+int trace_next(TraceReader *reader, TraceRecord *record) {
+    if (reader->binary) {
+        if (reader->position >= reader->header->record_count) return 0;
+        if (reader->position >= reader->window_end) {
+            trace_advance_window(reader);
+        }
+        
+        const TraceFileRecord *r = &reader->records[reader->position++];
+        if (r->pid < 1 || r->pid > MAX_PROCESSES || r->page_number > 0x7fffffffU) return -1;
+        record->pid = r->pid;
+        record->page_number = (int)r->page_number;
+        record->op = (r->op == 'w') ? 'w' : 'r';
+        return 1;
+    }
     
-    // Si no hay marcos libres, hacer swap out de una página
-    if (ram_frame == -1) {
-        int victim_frame = select_victim_page_fifo();
-        if (victim_frame == -1) {
-            char msg[256];
-            snprintf(msg, sizeof(msg), "ERROR: No se pudo encontrar página víctima para Proceso %d", pid);
-            add_log(msg);
+    char line[MAX_LINE_LENGTH];
+    while (fgets(line, sizeof(line), reader->file)) {
+        reader->line_number++;
+        int parsed = parse_trace_line(line, record);
+        if (parsed != 0) return parsed;
+    }
+    return 0;
+}
+
+// Obtener la mayor página accedida por cada PID
+// En trazas binarias se lee la tabla de procesos; en texto se recorre la traza.
+bool trace_collect_processes(TraceReader *reader, int max_page[]) {
+    for (int i = 0; i <= MAX_PROCESSES; i++) {
+        max_page[i] = -1;
+    }
+    
+    if (reader->binary) {
+        uint32_t count = reader->header->num_processes;
+        for (uint32_t i = 0; i < count; i++) {
+            if (reader->process_table[i].num_pages == 0) continue;
+            if (i + 1 > MAX_PROCESSES) {
+                printf("❌ Error: La traza usa PID %u (máximo %d).\n", i + 1, MAX_PROCESSES);
+                return false;
+            }
+            max_page[i + 1] = (int)reader->process_table[i].num_pages - 1;
+        }
+        return true;
+    }
+    
+    TraceRecord record;
+    int parsed;
+    while ((parsed = trace_next(reader, &record)) != 0) {
+        if (parsed < 0) {
+            printf("❌ Error: Línea %llu inválida en la traza.\n", reader->line_number);
             return false;
         }
+        if (record.page_number > max_page[record.pid]) {
+            max_page[record.pid] = record.page_number;
+        }
+    }
+    trace_rewind(reader);
+    return true;
+}
+
+// Volver al inicio de la traza
+void trace_rewind(TraceReader *reader) {
+    if (reader->binary) {
+        reader->position = 0;
+        reader->window_end = 0;
+        trace_advance_window(reader);
+    } else {
+        rewind(reader->file);
+        reader->line_number = 0;
+    }
+}
+
+// Crear un cursor propio sobre una traza binaria ya abierta. Comparte el
+// mapeo de solo lectura de source, que debe seguir abierto mientras se use.
+void trace_share(const TraceReader *source, TraceReader *cursor) {
+    *cursor = *source;
+    cursor->shared = true;
+    cursor->file = NULL;
+    cursor->position = 0;
+    cursor->window_end = 0;
+    trace_advance_window(cursor);
+}
+
+// Cerrar la traza
+void trace_close(TraceReader *reader) {
+#ifndef _WIN32
+    if (reader->map && !reader->shared) {
+        munmap(reader->map, reader->map_size);
+    }
+#endif
+    if (reader->file) {
+        fclose(reader->file);
+    }
+    memset(reader, 0, sizeof(*reader));
+}
+
+// Convertir una traza de texto al formato binario
+bool convert_trace(const char *text_file, const char *binary_file) {
+    FILE *in = fopen(text_file, "r");
+    if (!in) {
+        printf("❌ Error: No se pudo abrir la traza '%s'.\n", text_file);
+        return false;
+    }
+    
+    FILE *out = fopen(binary_file, "wb");
+    if (!out) {
+        printf("❌ Error: No se pudo crear '%s'.\n", binary_file);
+        fclose(in);
+        return false;
+    }
+    
+    TraceFileHeader header;
+    TraceFileProcess table[MAX_PROCESSES];
+    memset(&header, 0, sizeof(header));
+    memset(table, 0, sizeof(table));
+    memcpy(header.magic, TRACE_MAGIC, sizeof(header.magic));
+    header.version = TRACE_VERSION;
+    header.record_size = sizeof(TraceFileRecord);
+    header.num_processes = MAX_PROCESSES;
+    
+    // Reservar espacio para cabecera y tabla (se reescriben al final)
+    fwrite(&header, sizeof(header), 1, out);
+    fwrite(table, sizeof(table), 1, out);
+    
+    char line[MAX_LINE_LENGTH];
+    unsigned long long line_number = 0;
+    TraceRecord record;
+    bool ok = true;
+    
+    while (fgets(line, sizeof(line), in)) {
+        line_number++;
+        int parsed = parse_trace_line(line, &record);
+        if (parsed == 0) continue;
+        if (parsed < 0) {
+            printf("❌ Error: Línea %llu inválida en la traza: %s", line_number, line);
+            ok = false;
+            break;
+        }
         
-        if (!swap_out_page(victim_frame)) {
-            return false;
+        TraceFileRecord r;
+        r.page_number = (uint32_t)record.page_number;
+        r.pid = (uint16_t)record.pid;
+        r.op = (uint8_t)record.op;
+        r.reserved = 0;
+        if (fwrite(&r, sizeof(r), 1, out) != 1) {
+            ok = false;
+            break;
         }
         
-        ram_frame = victim_frame;
+        if ((uint32_t)record.page_number + 1 > table[record.pid - 1].num_pages) {
+            table[record.pid - 1].num_pages = (uint32_t)record.page_number + 1;
+        }
+        header.record_count++;
     }
     
-    // Mover página de Swap a RAM
-    mem_system->ram_frames[ram_frame].pid = pid;
-    mem_system->ram_frames[ram_frame].page_number = page_number;
-    mem_system->ram_frames[ram_frame].occupied = true;
-    mem_system->ram_frames[ram_frame].load_time = time(NULL);
+    if (ok) {
+        rewind(out);
+        ok = fwrite(&header, sizeof(header), 1, out) == 1 &&
+             fwrite(table, sizeof(table), 1, out) == 1;
+    }
     
-    // Actualizar tabla de páginas
-    page_entry->state = PAGE_IN_RAM;
-    page_entry->frame_number = ram_frame;
-    page_entry->swap_position = -1;
-    page_entry->valid = true;
-    page_entry->load_time = time(NULL);
+    fclose(in);
+    if (fclose(out) != 0) ok = false;
+    
+    if (ok) {
+        printf("✓ Traza convertida: %llu registros (%llu bytes) en %s\n", 
+               (unsigned long long)header.record_count,
+               (unsigned long long)(sizeof(header) + sizeof(table) + 
+                                    header.record_count * sizeof(TraceFileRecord)),
+               binary_file);
+    } else {
+        printf("❌ Error: No se pudo convertir la traza.\n");
+        remove(binary_file);
+    }
+    return ok;
+}
+
+// Construir el oráculo de OPT: una pasada hacia atrás sobre la traza
+// enlaza cada acceso con el siguiente acceso a la misma página.
+bool opt_build_oracle(TraceReader *reader, const int max_page[], OptOracle *oracle) {
+    memset(oracle, 0, sizeof(*oracle));
     
-    // Liberar marco en Swap
-    mem_system->swap_frames[swap_position].pid = -1;
-    mem_system->swap_frames[swap_position].page_number = -1;
-    mem_system->swap_frames[swap_position].occupied = false;
+    // Las trazas de texto se cargan en memoria; las binarias se leen del mapeo
+    const TraceFileRecord *records = NULL;
+    TraceFileRecord *loaded = NULL;
+    uint64_t count = 0;
     
-    // Actualizar TLB
-    tlb_update(pid, page_number, ram_frame);
+    if (reader->binary) {
+        records = reader->records;
+        count = reader->header->record_count;
+    } else {
+        uint64_t capacity = 1024;
+        loaded = (TraceFileRecord*)malloc(capacity * sizeof(TraceFileRecord));
+        TraceRecord record;
+        int parsed;
+        while ((parsed = trace_next(reader, &record)) != 0) {
+            if (parsed < 0) {
+                free(loaded);
+                trace_rewind(reader);
+                return false;
+            }
+            if (count == capacity) {
+                capacity *= 2;
+                loaded = (TraceFileRecord*)realloc(loaded, capacity * sizeof(TraceFileRecord));
+            }
+            loaded[count].pid = (uint16_t)record.pid;
+            loaded[count].page_number = (uint32_t)record.page_number;
+            count++;
+        }
+        trace_rewind(reader);
+        records = loaded;
+    }
     
-    // Agregar a cola FIFO
-    enqueue_fifo(mem_system->fifo_queue, ram_frame);
+    oracle->record_count = count;
+    oracle->next_use = (uint64_t*)malloc((count > 0 ? count : 1) * sizeof(uint64_t));
+    for (int pid = 1; pid <= MAX_PROCESSES; pid++) {
+        oracle->sim_to_trace[pid] = -1;
+        oracle->num_pages[pid] = max_page[pid] + 1;
+        if (max_page[pid] < 0) continue;
+        
+        oracle->first_use[pid] = (uint64_t*)malloc(oracle->num_pages[pid] * sizeof(uint64_t));
+        oracle->next_pos[pid] = (uint64_t*)malloc(oracle->num_pages[pid] * sizeof(uint64_t));
+        for (int page = 0; page < oracle->num_pages[pid]; page++) {
+            oracle->first_use[pid][page] = OPT_NEVER;
+        }
+    }
     
-    // Actualizar estadísticas
-    mem_system->total_swaps++;
-    process->page_faults++;
-    mem_system->total_page_faults++;
+    // Al terminar, first_use contiene el primer uso de cada página
+    for (uint64_t i = count; i-- > 0; ) {
+        int pid = records[i].pid;
+        uint32_t page = records[i].page_number;
+        if (pid < 1 || pid > MAX_PROCESSES || (int64_t)page >= oracle->num_pages[pid]) {
+            oracle->next_use[i] = OPT_NEVER;
+            continue;
+        }
+        oracle->next_use[i] = oracle->first_use[pid][page];
+        oracle->first_use[pid][page] = i;
+    }
+    
+    free(loaded);
+    return true;
+}
+
+// Liberar el oráculo de OPT
+void opt_free_oracle(OptOracle *oracle) {
+    free(oracle->next_use);
+    for (int pid = 1; pid <= MAX_PROCESSES; pid++) {
+        free(oracle->first_use[pid]);
+        free(oracle->next_pos[pid]);
+    }
+    memset(oracle, 0, sizeof(*oracle));
+}
+
+// Crear un proceso por PID de la traza (en orden de PID)
+static bool replay_create_processes(const int max_page[], int pid_map[]) {
+    for (int pid = 1; pid <= MAX_PROCESSES; pid++) {
+        pid_map[pid] = -1;
+        if (max_page[pid] < 0) continue;
+        
+        char name[32];
+        snprintf(name, sizeof(name), "traza_%d", pid);
+        mm_lock();
+        // En 64 bits: las páginas de la traza llegan a 2^31 - 1
+        pid_map[pid] = create_process(name, ((long long)max_page[pid] + 1) * PAGE_SIZE);
+        mm_unlock();
+        if (pid_map[pid] == -1) {
+            printf("❌ Error: No se pudo crear el proceso de la traza con PID %d (%lld páginas).\n", 
+                   pid, (long long)max_page[pid] + 1);
+            return false;
+        }
+    }
+    return true;
+}
+
+// Ejecutar todos los accesos de la traza
+// Con oráculo, antes de cada acceso se avanza el próximo uso de la página.
+static void replay_accesses(TraceReader *reader, const int pid_map[], OptOracle *oracle,
+                            unsigned long long *total_records, unsigned long long *errors) {
+    TraceRecord record;
+    int parsed;
+    uint64_t position = 0;
     
-    char msg[256];
-    snprintf(msg, sizeof(msg), "SWAP IN: Proceso %d, Página %d movida de Swap[%d] a RAM[%d]", 
-             pid, page_number, swap_position, ram_frame);
-    add_log(msg);
+    while ((parsed = trace_next(reader, &record)) != 0) {
+        (*total_records)++;
+        if (parsed < 0 || pid_map[record.pid] == -1) {
+            (*errors)++;
+            position++;
+            continue;
+        }
+        if (oracle && record.page_number < oracle->num_pages[record.pid]) {
+            oracle->next_pos[record.pid][record.page_number] = oracle->next_use[position];
+        }
+        AccessResult result = access_page(pid_map[record.pid], record.page_number, record.op == 'w');
+#ifndef _WIN32
+        // Con kswapd despierto se le cede la CPU entre accesos
+        if (__atomic_load_n(&mem_system->kswapd_woken, __ATOMIC_RELAXED)) sched_yield();
+#endif
+        if (result == ACCESS_ERROR) {
+            (*errors)++;
+        }
+        position++;
+    }
     
+    // Las estadísticas se leen con kswapd ya detenido
+    kswapd_stop();
+}
+
+// Preparar el sistema para una pasada: procesos y, si aplica, el oráculo
+static bool replay_prepare(const int max_page[], int pid_map[], OptOracle *oracle) {
+    if (!replay_create_processes(max_page, pid_map)) {
+        return false;
+    }
+    if (oracle) {
+        for (int pid = 1; pid <= MAX_PROCESSES; pid++) {
+            if (pid_map[pid] != -1) oracle->sim_to_trace[pid_map[pid]] = pid;
+            if (oracle->next_pos[pid]) {
+                memcpy(oracle->next_pos[pid], oracle->first_use[pid], 
+                       oracle->num_pages[pid] * sizeof(uint64_t));
+            }
+        }
+        mm_lock();
+        opt_attach_oracle(oracle);
+        mm_unlock();
+    }
     return true;
 }
 
-// Asignar página en RAM
-int allocate_page_in_ram(int pid, int page_number) {
-    // Buscar marco libre
-    int frame_index = find_free_ram_frame();
+// Repartir la traza entre los núcleos: cada proceso va entero a un núcleo
+// (PID de la traza módulo el número de núcleos) y conserva su orden
+static void replay_split(TraceReader *reader, const int pid_map[], CoreStream streams[], 
+                         int num_cores, unsigned long long *total_records, 
+                         unsigned long long *errors) {
+    for (int c = 0; c < num_cores; c++) {
+        streams[c].core = c;
+        streams[c].system = mem_system;
+        streams[c].records = NULL;
+        streams[c].count = 0;
+        streams[c].capacity = 0;
+        streams[c].errors = 0;
+    }
     
-    // Si no hay marcos libres, hacer swap out
-    if (frame_index == -1) {
-        int victim_frame = select_victim_page_fifo();
-        if (victim_frame == -1) {
-            return -1; // No se pudo hacer swap out
+    TraceRecord record;
+    int parsed;
+    while ((parsed = trace_next(reader, &record)) != 0) {
+        (*total_records)++;
+        if (parsed < 0 || pid_map[record.pid] == -1) {
+            (*errors)++;
+            continue;
         }
         
-        if (!swap_out_page(victim_frame)) {
-            return -1;
+        CoreStream *stream = &streams[record.pid % num_cores];
+        if (stream->count == stream->capacity) {
+            stream->capacity = stream->capacity ? stream->capacity * 2 : 4096;
+            stream->records = (TraceRecord*)realloc(stream->records, 
+                                                    stream->capacity * sizeof(TraceRecord));
         }
-        
-        frame_index = victim_frame;
+        record.pid = pid_map[record.pid];
+        stream->records[stream->count++] = record;
     }
-    
-    // Asignar marco
-    mem_system->ram_frames[frame_index].pid = pid;
-    mem_system->ram_frames[frame_index].page_number = page_number;
-    mem_system->ram_frames[frame_index].occupied = true;
-    mem_system->ram_frames[frame_index].load_time = time(NULL);
-    
-    // Agregar a cola FIFO
-    enqueue_fifo(mem_system->fifo_queue, frame_index);
-    
-    return frame_index;
 }
 
-// Crear proceso - CORREGIDO PARA NO HACER SWAP OUT AL CREAR
-int create_process(const char *name, int size_kb) {
-    if (mem_system->num_processes >= MAX_PROCESSES) {
-        printf("❌ Error: Número máximo de procesos alcanzado.\n");
-        return -1;
-    }
+// Hilo de un núcleo: ejecuta su flujo por el mismo camino que la opción 7
+static void *core_replay_main(void *arg) {
+    CoreStream *stream = (CoreStream*)arg;
+    sim_attach(stream->system);
+    current_core = stream->core;
     
-    if (size_kb <= 0) {
-        printf("❌ Error: Tamaño de proceso inválido.\n");
-        return -1;
+    for (uint64_t i = 0; i < stream->count; i++) {
+        const TraceRecord *record = &stream->records[i];
+        if (access_page(record->pid, record->page_number, record->op == 'w') == ACCESS_ERROR) {
+            stream->errors++;
+        }
+#ifndef _WIN32
+        if (__atomic_load_n(&mem_system->kswapd_woken, __ATOMIC_RELAXED)) sched_yield();
+#endif
     }
-    
-    // Calcular número de páginas necesarias
-    int num_pages = (size_kb + PAGE_SIZE - 1) / PAGE_SIZE; // Redondeo hacia arriba
-    
-    // Verificar si hay suficiente espacio (RAM + Swap)
-    int total_space = (NUM_RAM_FRAMES + NUM_SWAP_FRAMES) * PAGE_SIZE;
-    int used_space = 0;
-    
-    for (int i = 0; i < NUM_RAM_FRAMES; i++) {
-        if (mem_system->ram_frames[i].occupied) {
-            used_space += PAGE_SIZE;
+    return NULL;
+}
+
+// Ejecutar los flujos, un hilo por núcleo, y esperar a que terminen
+static void replay_cores(CoreStream streams[], int num_cores, unsigned long long *errors) {
+#ifdef _WIN32
+    for (int c = 0; c < num_cores; c++) core_replay_main(&streams[c]);
+    current_core = 0;
+#else
+    for (int c = 0; c < num_cores; c++) {
+        if (pthread_create(&streams[c].thread, NULL, core_replay_main, &streams[c]) != 0) {
+            core_replay_main(&streams[c]);
+            streams[c].thread = pthread_self();
         }
     }
-    for (int i = 0; i < NUM_SWAP_FRAMES; i++) {
-        if (mem_system->swap_frames[i].occupied) {
-            used_space += PAGE_SIZE;
+    for (int c = 0; c < num_cores; c++) {
+        if (!pthread_equal(streams[c].thread, pthread_self())) {
+            pthread_join(streams[c].thread, NULL);
         }
     }
-    
-    if (used_space + (num_pages * PAGE_SIZE) > total_space) {
-        printf("❌ Error: No hay suficiente espacio en memoria (RAM + Swap).\n");
-        return -1;
+    current_core = 0;
+#endif
+    for (int c = 0; c < num_cores; c++) {
+        *errors += streams[c].errors;
+        free(streams[c].records);
+        streams[c].records = NULL;
     }
     
-    // Buscar slot libre para el proceso
-    int slot = -1;
-    for (int i = 0; i < MAX_PROCESSES; i++) {
-        if (mem_system->processes[i] == NULL) {
-            slot = i;
-            break;
-        }
+    // Las estadísticas se leen con kswapd ya detenido
+    kswapd_stop();
+    cores_fold_stats();
+}
+
+// Reproducir una traza de accesos sin interacción
+// Primero se crea un proceso por PID con tantas páginas como la mayor accedida;
+// luego se ejecuta cada acceso por el mismo camino que la opción 7.
+// Con compare_opt se hace antes una pasada con OPT como cota inferior.
+bool replay_trace(const char *filename, bool compare_opt) {
+    TraceReader reader;
+    if (!trace_open(&reader, filename)) {
+        return false;
     }
     
-    if (slot == -1) {
-        printf("❌ Error: No hay slots disponibles para procesos.\n");
-        return -1;
+    int max_page[MAX_PROCESSES + 1];
+    int pid_map[MAX_PROCESSES + 1];
+    if (!trace_collect_processes(&reader, max_page)) {
+        trace_close(&reader);
+        return false;
     }
     
-    // Crear PCB
-    PCB *process = (PCB*)malloc(sizeof(PCB));
-    process->pid = slot + 1; // PID comienza en 1
-    strncpy(process->name, name, sizeof(process->name) - 1);
-    process->name[sizeof(process->name) - 1] = '\0';
-    process->size = size_kb;
-    process->num_pages = num_pages;
-    process->state = PROC_ACTIVE;
-    process->creation_time = time(NULL);
-    process->page_faults = 0;
+    // El oráculo se necesita si la política es OPT o se pide la comparación
+    bool live_opt = strcmp(REPLACEMENT, "OPT") == 0;
+    if (CORES > 1 && (compare_opt || live_opt)) {
+        printf("❌ Error: OPT necesita el orden global de la traza (use CORES = 1).\n");
+        trace_close(&reader);
+        return false;
+    }
+    OptOracle oracle;
+    if ((compare_opt || live_opt) && !opt_build_oracle(&reader, max_page, &oracle)) {
+        printf("❌ Error: No se pudo indexar la traza para OPT.\n");
+        trace_close(&reader);
+        return false;
+    }
     
-    // Crear tabla de páginas
-    process->page_table = (PageTableEntry*)malloc(num_pages * sizeof(PageTableEntry));
+    unsigned long long total_records = 0;
+    unsigned long long errors = 0;
     
-    // LÓGICA CORREGIDA: Asignar páginas SOLO EN MARCOS LIBRES
-    // No hacer swap out de procesos existentes al crear uno nuevo
-    int pages_in_ram = 0;
-    for (int i = 0; i < num_pages; i++) {
-        // Verificar si hay marco libre en RAM
-        int frame = find_free_ram_frame();
+    // Pasada de referencia con OPT
+    if (compare_opt && !live_opt) {
+        char live_policy[sizeof(REPLACEMENT)];
+        strcpy(live_policy, REPLACEMENT);
+        strcpy(REPLACEMENT, "OPT");
+        init_system();
         
-        if (frame != -1) {
-            // Asignar directamente en RAM (sin hacer swap out de procesos existentes)
-            mem_system->ram_frames[frame].pid = process->pid;
-            mem_system->ram_frames[frame].page_number = i;
-            mem_system->ram_frames[frame].occupied = true;
-            mem_system->ram_frames[frame].load_time = time(NULL);
-            
-            // Agregar a cola FIFO
-            enqueue_fifo(mem_system->fifo_queue, frame);
-            
-            process->page_table[i].page_number = i;
-            process->page_table[i].frame_number = frame;
-            process->page_table[i].state = PAGE_IN_RAM;
-            process->page_table[i].valid = true;
-            process->page_table[i].modified = false;
-            process->page_table[i].swap_position = -1;
-            process->page_table[i].last_access = time(NULL);
-            process->page_table[i].load_time = time(NULL);
-            
-            // Actualizar TLB
-            tlb_update(process->pid, i, frame);
-            
-            pages_in_ram++;
-        } else {
-            // No hay marcos libres en RAM, asignar directamente en Swap
-            int swap_frame = find_free_swap_frame();
-            if (swap_frame == -1) {
-                // No hay espacio ni en RAM ni en Swap
-                printf("❌ Error: No hay espacio disponible para el proceso.\n");
-                
-                // Liberar páginas ya asignadas
-                for (int j = 0; j < i; j++) {
-                    if (process->page_table[j].state == PAGE_IN_RAM) {
-                        int f = process->page_table[j].frame_number;
-                        mem_system->ram_frames[f].occupied = false;
-                        mem_system->ram_frames[f].pid = -1;
-                    } else if (process->page_table[j].state == PAGE_IN_SWAP) {
-                        int s = process->page_table[j].swap_position;
-                        mem_system->swap_frames[s].occupied = false;
-                        mem_system->swap_frames[s].pid = -1;
-                    }
-                }
-                
-                free(process->page_table);
-                free(process);
-                return -1;
-            }
-            
-            // Asignar directamente en Swap (sin hacer swap out)
-            mem_system->swap_frames[swap_frame].pid = process->pid;
-            mem_system->swap_frames[swap_frame].page_number = i;
-            mem_system->swap_frames[swap_frame].occupied = true;
-            mem_system->swap_frames[swap_frame].load_time = time(NULL);
-            
-            process->page_table[i].page_number = i;
-            process->page_table[i].frame_number = -1;
-            process->page_table[i].state = PAGE_IN_SWAP;
-            process->page_table[i].valid = false;
-            process->page_table[i].modified = false;
-            process->page_table[i].swap_position = swap_frame;
-            process->page_table[i].last_access = 0;
-            process->page_table[i].load_time = time(NULL);
+        bool ok = replay_prepare(max_page, pid_map, &oracle);
+        if (ok) {
+            replay_accesses(&reader, pid_map, &oracle, &total_records, &errors);
+            opt_baseline.valid = true;
+            opt_baseline.page_faults = mem_system->total_page_faults;
+            opt_baseline.swap_reads = mem_system->total_swap_reads;
+            opt_baseline.swap_writes = mem_system->total_swap_writes;
+        }
+        
+        free_system();
+        strcpy(REPLACEMENT, live_policy);
+        trace_rewind(&reader);
+        total_records = 0;
+        errors = 0;
+        if (!ok) {
+            opt_free_oracle(&oracle);
+            trace_close(&reader);
+            return false;
         }
     }
     
-    // Si todas las páginas están en Swap, o algunas están en Swap, marcar proceso como SWAPPED
-    if (pages_in_ram == 0 || (pages_in_ram > 0 && pages_in_ram < num_pages)) {
-        process->state = PROC_SWAPPED;
+    init_system();
+    OptOracle *live_oracle = live_opt ? &oracle : NULL;
+    if (!replay_prepare(max_page, pid_map, live_oracle)) {
+        free_system();
+        if (compare_opt || live_opt) opt_free_oracle(&oracle);
+        trace_close(&reader);
+        return false;
     }
     
-    // Agregar proceso al sistema
-    mem_system->processes[slot] = process;
-    mem_system->num_processes++;
+    struct timespec start, end;
+    if (CORES > 1) {
+        // Los flujos se reparten antes para medir solo la simulación
+        CoreStream *streams = (CoreStream*)malloc(CORES * sizeof(CoreStream));
+        replay_split(&reader, pid_map, streams, CORES, &total_records, &errors);
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        replay_cores(streams, CORES, &errors);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        free(streams);
+    } else {
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        replay_accesses(&reader, pid_map, live_oracle, &total_records, &errors);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+    }
     
-    char msg[256];
-    snprintf(msg, sizeof(msg), 
-             "Proceso creado: PID=%d, Nombre='%s', Tamaño=%d KB, Páginas=%d (RAM:%d, Swap:%d)", 
-             process->pid, process->name, size_kb, num_pages, pages_in_ram, num_pages - pages_in_ram);
-    add_log(msg);
+    bool binary = reader.binary;
+    trace_close(&reader);
     
-    printf("\n✓ Proceso creado exitosamente:\n");
-    printf("  PID: %d\n", process->pid);
-    printf("  Nombre: %s\n", process->name);
-    printf("  Tamaño: %d KB\n", size_kb);
-    printf("  Páginas: %d (Tamaño de página: %d KB)\n", num_pages, PAGE_SIZE);
-    printf("  Páginas en RAM: %d\n", pages_in_ram);
-    printf("  Páginas en Swap: %d\n", num_pages - pages_in_ram);
+    double elapsed = (double)(end.tv_sec - start.tv_sec) + 
+                     (double)(end.tv_nsec - start.tv_nsec) / 1e9;
     
-    if (pages_in_ram < num_pages) {
-        printf("  ⚠️  Estado: SWAPPED (algunas páginas en swap debido a memoria RAM llena)\n");
+    printf("\n╔════════════════════════════════════════════════════════════╗\n");
+    printf("║                 REPRODUCCIÓN DE TRAZA                      ║\n");
+    printf("╚════════════════════════════════════════════════════════════╝\n\n");
+    printf("  %-40s %s (%s)\n", "Traza:", filename, binary ? "binaria" : "texto");
+    printf("  %-40s %llu\n", "Accesos reproducidos:", total_records);
+    printf("  %-40s %llu\n", "Accesos con error:", errors);
+    printf("  %-40s %d\n", "Núcleos simulados:", CORES > 1 ? CORES : 1);
+    printf("  %-40s %.3f s\n", "Tiempo de reproducción:", elapsed);
+    if (elapsed > 0) {
+        printf("  %-40s %.0f accesos/s\n", "Rendimiento:", total_records / elapsed);
     }
     
-    return process->pid;
+    display_statistics();
+    free_system();
+    if (compare_opt || live_opt) opt_free_oracle(&oracle);
+    return errors == 0;
 }
 
-// Terminar proceso
-bool terminate_process(int pid) {
-    PCB *process = find_process(pid);
-    if (!process) {
-        printf("❌ Error: Proceso con PID %d no encontrado.\n", pid);
+// Medir la escalabilidad: la misma traza con 1, 2, ..., max_cores núcleos.
+// Cada fila es un sistema nuevo; se informa el rendimiento real de los
+// hilos, los fallos, los shootdowns entre núcleos y la contención del
+// cerrojo global (el camino de fallo está serializado por él).
+bool scale_trace(const char *filename, int max_cores) {
+    if (strcmp(REPLACEMENT, "OPT") == 0) {
+        printf("❌ Error: OPT necesita el orden global de la traza.\n");
         return false;
     }
     
-    // Liberar páginas en RAM
-    for (int i = 0; i < process->num_pages; i++) {
-        if (process->page_table[i].state == PAGE_IN_RAM) {
-            int frame = process->page_table[i].frame_number;
-            mem_system->ram_frames[frame].occupied = false;
-            mem_system->ram_frames[frame].pid = -1;
-            mem_system->ram_frames[frame].page_number = -1;
-        } else if (process->page_table[i].state == PAGE_IN_SWAP) {
-            int swap_frame = process->page_table[i].swap_position;
-            mem_system->swap_frames[swap_frame].occupied = false;
-            mem_system->swap_frames[swap_frame].pid = -1;
-            mem_system->swap_frames[swap_frame].page_number = -1;
-        }
-    }
-    
-    // Invalidar entradas de TLB
-    tlb_invalidate(pid);
-    
-    // Actualizar estado
-    process->state = PROC_TERMINATED;
-    
-    char msg[256];
-    snprintf(msg, sizeof(msg), "Proceso terminado: PID=%d, Nombre='%s', Page Faults=%d", 
-             process->pid, process->name, process->page_faults);
-    add_log(msg);
-    
-    // Buscar slot del proceso
-    for (int i = 0; i < MAX_PROCESSES; i++) {
-        if (mem_system->processes[i] && mem_system->processes[i]->pid == pid) {
-            free(mem_system->processes[i]->page_table);
-            free(mem_system->processes[i]);
-            mem_system->processes[i] = NULL;
-            mem_system->num_processes--;
-            break;
-        }
+    TraceReader reader;
+    if (!trace_open(&reader, filename)) {
+        return false;
     }
     
-    printf("✓ Proceso %d terminado y memoria liberada.\n", pid);
-    return true;
-}
-
-// Mostrar mapa de memoria
-void display_memory_map() {
-    printf("\n╔════════════════════════════════════════════════════════════╗\n");
-    printf("║                    MAPA DE MEMORIA RAM                     ║\n");
-    printf("╚════════════════════════════════════════════════════════════╝\n\n");
-    
-    int free_frames = 0;
-    for (int i = 0; i < NUM_RAM_FRAMES; i++) {
-        if (mem_system->ram_frames[i].occupied) {
-            printf("  [Marco %2d] Proceso %d, Página %d\n", 
-                   i, mem_system->ram_frames[i].pid, mem_system->ram_frames[i].page_number);
-        } else {
-            printf("  [Marco %2d] [LIBRE]\n", i);
-            free_frames++;
-        }
+    int max_page[MAX_PROCESSES + 1];
+    int pid_map[MAX_PROCESSES + 1];
+    if (!trace_collect_processes(&reader, max_page)) {
+        trace_close(&reader);
+        return false;
     }
     
-    printf("\n  Total marcos RAM: %d | Libres: %d | Ocupados: %d\n", 
-           NUM_RAM_FRAMES, free_frames, NUM_RAM_FRAMES - free_frames);
-    printf("  Utilización: %.2f%%\n", 
-           ((float)(NUM_RAM_FRAMES - free_frames) / NUM_RAM_FRAMES) * 100);
-    
     printf("\n╔════════════════════════════════════════════════════════════╗\n");
-    printf("║                   MAPA DE ÁREA DE SWAP                     ║\n");
+    printf("║              ESCALABILIDAD MULTINÚCLEO                     ║\n");
     printf("╚════════════════════════════════════════════════════════════╝\n\n");
+    printf("  %-40s %s\n", "Traza:", filename);
+    printf("  %-40s %s\n\n", "Política de reemplazo:", REPLACEMENT);
+    printf("  %-8s %-14s %-12s %-10s %-10s %-10s %-12s\n", "Núcleos", "Accesos/s", 
+           "Aceleración", "Fallos", "Directas", "IPIs", "Esperas");
+    printf("  %s\n", "--------------------------------------------------------------------------------");
     
-    int free_swap = 0;
-    int occupied_swap = 0;
-    
-    for (int i = 0; i < NUM_SWAP_FRAMES; i++) {
-        if (mem_system->swap_frames[i].occupied) {
-            printf("  [Swap %2d] Proceso %d, Página %d\n", 
-                   i, mem_system->swap_frames[i].pid, mem_system->swap_frames[i].page_number);
-            occupied_swap++;
-        } else {
-            free_swap++;
+    double base_rate = 0;
+    bool ok = true;
+    for (int n = 1; n <= max_cores && ok; n++) {
+        CORES = n;
+        init_system();
+        trace_rewind(&reader);
+        if (!replay_prepare(max_page, pid_map, NULL)) {
+            free_system();
+            ok = false;
+            break;
         }
+        
+        unsigned long long total_records = 0;
+        unsigned long long errors = 0;
+        CoreStream *streams = (CoreStream*)malloc(n * sizeof(CoreStream));
+        replay_split(&reader, pid_map, streams, n, &total_records, &errors);
+        
+        struct timespec start, end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        replay_cores(streams, n, &errors);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        free(streams);
+        
+        double elapsed = (double)(end.tv_sec - start.tv_sec) + 
+                         (double)(end.tv_nsec - start.tv_nsec) / 1e9;
+        double rate = elapsed > 0 ? mem_system->total_memory_accesses / elapsed : 0;
+        if (n == 1) base_rate = rate;
+        
+        char speedup[16];
+        char contended[16];
+        snprintf(speedup, sizeof(speedup), "%.2fx", base_rate > 0 ? rate / base_rate : 0.0);
+        snprintf(contended, sizeof(contended), "%.2f%%", mem_system->lock_acquired > 0 ? 
+                 (double)mem_system->lock_contended * 100 / mem_system->lock_acquired : 0.0);
+        printf("  %-8d %-14.0f %-12s %-10llu %-10llu %-10llu %-12s\n", n, rate, 
+               speedup, mem_system->total_page_faults, 
+               mem_system->total_direct_reclaims, mem_system->total_tlb_ipis, 
+               n > 1 ? contended : "-");
+        
+        ok = errors == 0;
+        free_system();
     }
     
-    if (occupied_swap == 0) {
-        printf("  [Área de Swap vacía]\n");
-    }
-    
-    printf("\n  Total marcos Swap: %d | Libres: %d | Ocupados: %d\n", 
-           NUM_SWAP_FRAMES, free_swap, occupied_swap);
-    printf("  Utilización: %.2f%%\n", 
-           ((float)occupied_swap / NUM_SWAP_FRAMES) * 100);
+    trace_close(&reader);
+    printf("\n  Directas = fallos que reclamaron marcos ellos mismos; IPIs = shootdowns\n");
+    printf("  que invalidaron la TLB de otro núcleo (con kswapd, cualquier TLB);\n");
+    printf("  Esperas = veces que el cerrojo global estaba tomado.\n");
+    return ok;
 }
 
-// Mostrar tabla de páginas de un proceso
-void display_process_table(int pid) {
-    PCB *process = find_process(pid);
-    if (!process) {
-        printf("❌ Error: Proceso con PID %d no encontrado.\n", pid);
-        return;
+// Leer la malla del barrido: líneas "CLAVE = v1, v2, ..." con las claves de
+// SWEEP_KEYS. Los parámetros que no aparecen conservan el valor de config.ini.
+static bool sweep_load_grid(const char *filename, SweepAxis axes[]) {
+    FILE *file = fopen(filename, "r");
+    if (!file) {
+        printf("❌ Error: No se pudo abrir la malla '%s'.\n", filename);
+        return false;
     }
-    
-    printf("\n╔════════════════════════════════════════════════════════════╗\n");
-    printf("║            TABLA DE PÁGINAS - Proceso %d                    ║\n", pid);
-    printf("╚════════════════════════════════════════════════════════════╝\n\n");
-    
-    printf("  Nombre: %s\n", process->name);
-    printf("  Tamaño: %d KB\n", process->size);
-    printf("  Número de páginas: %d\n", process->num_pages);
-    printf("  Estado: ");
-    
-    switch (process->state) {
-        case PROC_ACTIVE: printf("ACTIVO\n"); break;
-        case PROC_SUSPENDED: printf("SUSPENDIDO\n"); break;
-        case PROC_SWAPPED: printf("INTERCAMBIADO (parcial)\n"); break;
-        case PROC_TERMINATED: printf("TERMINADO\n"); break;
+    for (int a = 0; a < SWEEP_AXES; a++) {
+        axes[a].count = 0;
     }
     
-    printf("  Page Faults: %d\n\n", process->page_faults);
-    
-    printf("  %-8s %-12s %-12s %-8s %-12s\n", 
-           "Página", "Estado", "Marco RAM", "Válido", "Swap Pos");
-    printf("  %s\n", "----------------------------------------------------------------");
-    
-    for (int i = 0; i < process->num_pages; i++) {
-        PageTableEntry *entry = &process->page_table[i];
+    char line[MAX_LINE_LENGTH * 4];
+    int line_number = 0;
+    bool ok = true;
+    while (ok && fgets(line, sizeof(line), file)) {
+        line_number++;
+        char *p = line;
+        while (isspace((unsigned char)*p)) p++;
+        if (*p == '\0' || *p == '#' || *p == '[') continue;
         
-        printf("  %-8d ", entry->page_number);
+        char *equals = strchr(p, '=');
+        char key[MAX_LINE_LENGTH];
+        if (!equals || sscanf(p, "%255[A-Z_]", key) != 1) {
+            printf("❌ Error: Línea %d inválida en la malla.\n", line_number);
+            ok = false;
+            break;
+        }
+        int axis = -1;
+        for (int a = 0; a < SWEEP_AXES; a++) {
+            if (strcmp(key, SWEEP_KEYS[a]) == 0) axis = a;
+        }
+        if (axis < 0) {
+            printf("❌ Error: El barrido no admite la clave %s (línea %d).\n", key, line_number);
+            ok = false;
+            break;
+        }
         
-        switch (entry->state) {
-            case PAGE_IN_RAM:
-                printf("%-12s %-12d %-8s %-12s\n", 
-                       "EN RAM", entry->frame_number, 
-                       entry->valid ? "Sí" : "No", "-");
-                break;
-            case PAGE_IN_SWAP:
-                printf("%-12s %-12s %-8s %-12d\n", 
-                       "EN SWAP", "-", "No", entry->swap_position);
-                break;
-            default:
-                printf("%-12s %-12s %-8s %-12s\n", 
-                       "LIBRE", "-", "No", "-");
+        // Valores separados por comas
+        char *value = equals + 1;
+        while (ok && *value) {
+            while (isspace((unsigned char)*value) || *value == ',') value++;
+            if (*value == '\0' || *value == '#') break;
+            size_t len = strcspn(value, ", \t\r\n#");
+            
+            SweepAxis *ax = &axes[axis];
+            if (ax->count == SWEEP_MAX_VALUES || len >= sizeof(ax->values[0])) {
+                printf("❌ Error: Demasiados valores o valor demasiado largo para %s.\n", key);
+                ok = false;
                 break;
+            }
+            memcpy(ax->values[ax->count], value, len);
+            ax->values[ax->count][len] = '\0';
+            value += len;
+            
+            char *end;
+            if (axis == SWEEP_AXES - 1) {
+                if (!find_policy(ax->values[ax->count])) {
+                    printf("❌ Error: Política de reemplazo '%s' desconocida.\n", ax->values[ax->count]);
+                    ok = false;
+                }
+            } else if (strtol(ax->values[ax->count], &end, 10) <= 0 || *end != '\0') {
+                printf("❌ Error: Valor '%s' inválido para %s.\n", ax->values[ax->count], key);
+                ok = false;
+            }
+            ax->count++;
         }
     }
+    fclose(file);
+    return ok;
 }
 
-// Mostrar estado del sistema
-void display_system_status() {
-    printf("\n╔════════════════════════════════════════════════════════════╗\n");
-    printf("║                   ESTADO DEL SISTEMA                       ║\n");
-    printf("╚════════════════════════════════════════════════════════════╝\n\n");
+// Ejecutar una configuración del barrido en el hilo actual, con su propia
+// instancia del simulador y su propio cursor sobre la traza compartida
+static void sweep_run(const Sweep *sweep, SweepRun *run) {
+    config_apply(&run->config);
+    quiet_mode = true;
+    CORES = 1;
+    if (RAM_SIZE < PAGE_SIZE) {
+        run->status = "invalida";
+        return;
+    }
     
-    printf("  PROCESOS ACTIVOS: %d\n\n", mem_system->num_processes);
+    TraceReader reader;
+    trace_share(sweep->trace, &reader);
+    bool opt = strcmp(REPLACEMENT, "OPT") == 0;
+    OptOracle oracle;
+    if (opt && !opt_build_oracle(&reader, sweep->max_page, &oracle)) {
+        run->status = "sin_memoria";
+        trace_close(&reader);
+        return;
+    }
     
-    if (mem_system->num_processes == 0) {
-        printf("  [No hay procesos activos]\n");
+    int pid_map[MAX_PROCESSES + 1];
+    init_system();
+    if (replay_prepare(sweep->max_page, pid_map, opt ? &oracle : NULL)) {
+        struct timespec start, end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        replay_accesses(&reader, pid_map, opt ? &oracle : NULL, &run->accesses, &run->errors);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        
+        cores_fold_stats();
+        run->seconds = (double)(end.tv_sec - start.tv_sec) + 
+                       (double)(end.tv_nsec - start.tv_nsec) / 1e9;
+        run->page_faults = mem_system->total_page_faults;
+        run->swap_reads = mem_system->total_swap_reads;
+        run->swap_writes = mem_system->total_swap_writes;
+        run->tlb_hits = mem_system->total_tlb_hits;
+        run->tlb_misses = mem_system->total_tlb_misses;
+        run->sim_time_ns = sim_time_total();
+        run->status = "ok";
     } else {
-        printf("  %-6s %-20s %-12s %-10s %-15s\n", 
-               "PID", "Nombre", "Tamaño", "Páginas", "Estado");
-        printf("  %s\n", "------------------------------------------------------------------------");
+        run->status = "sin_memoria";
+    }
+    free_system();
+    if (opt) opt_free_oracle(&oracle);
+    trace_close(&reader);
+#ifndef _WIN32
+    if (SWAP_FILE[0] != '\0') unlink(SWAP_FILE);
+#endif
+}
+
+// Trabajador del barrido: ejecuta configuraciones hasta agotar la malla
+static void *sweep_worker(void *arg) {
+    Sweep *sweep = (Sweep*)arg;
+    for (;;) {
+        int i = __atomic_fetch_add(&sweep->next, 1, __ATOMIC_RELAXED);
+        if (i >= sweep->count) break;
         
-        for (int i = 0; i < MAX_PROCESSES; i++) {
-            PCB *p = mem_system->processes[i];
-            if (p) {
-                printf("  %-6d %-20s %-12d %-10d ", 
-                       p->pid, p->name, p->size, p->num_pages);
-                
-                switch (p->state) {
-                    case PROC_ACTIVE: printf("%-15s\n", "ACTIVO"); break;
-                    case PROC_SUSPENDED: printf("%-15s\n", "SUSPENDIDO"); break;
-                    case PROC_SWAPPED: printf("%-15s\n", "INTERCAMBIADO"); break;
-                    case PROC_TERMINATED: printf("%-15s\n", "TERMINADO"); break;
-                }
+        SweepRun *run = &sweep->runs[i];
+        sweep_run(sweep, run);
+        int done = __atomic_add_fetch(&sweep->done, 1, __ATOMIC_RELAXED);
+        printf("  [%d/%d] RAM %d KB, Swap %d KB, página %d KB, TLB %d, %s: %s\n", 
+               done, sweep->count, run->config.ram_size, run->config.swap_size, 
+               run->config.page_size, run->config.tlb_size, run->config.replacement, 
+               run->status);
+    }
+    return NULL;
+}
+
+// Escribir una fila CSV por configuración, en el orden de la malla
+static bool sweep_write_csv(const char *filename, const Sweep *sweep) {
+    FILE *file = fopen(filename, "w");
+    if (!file) {
+        printf("❌ Error: No se pudo crear el archivo '%s'.\n", filename);
+        return false;
+    }
+    
+    fprintf(file, "ram_kb,swap_kb,page_kb,tlb_entries,policy,status,accesses,errors,"
+                  "page_faults,fault_rate,tlb_hit_rate,swap_reads,swap_writes,"
+                  "avg_access_ns,seconds\n");
+    for (int i = 0; i < sweep->count; i++) {
+        const SweepRun *run = &sweep->runs[i];
+        unsigned long long tlb_accesses = run->tlb_hits + run->tlb_misses;
+        fprintf(file, "%d,%d,%d,%d,%s,%s,%llu,%llu,%llu,%.6f,%.6f,%llu,%llu,%.2f,%.6f\n",
+                run->config.ram_size, run->config.swap_size, run->config.page_size,
+                run->config.tlb_size, run->config.replacement, run->status,
+                run->accesses, run->errors, run->page_faults,
+                run->accesses > 0 ? (double)run->page_faults / run->accesses : 0.0,
+                tlb_accesses > 0 ? (double)run->tlb_hits / tlb_accesses : 0.0,
+                run->swap_reads, run->swap_writes,
+                run->accesses > 0 ? (double)run->sim_time_ns / run->accesses : 0.0,
+                run->seconds);
+    }
+    fclose(file);
+    return true;
+}
+
+// Barrido de parámetros: la misma traza con cada combinación de la malla.
+// Cada configuración es una instancia independiente del simulador que corre
+// en un hilo trabajador; todos leen la misma traza binaria mapeada.
+bool sweep_trace(const char *filename, const char *grid_file, const char *csv_file, int jobs) {
+    SweepAxis axes[SWEEP_AXES];
+    if (!sweep_load_grid(grid_file, axes)) {
+        return false;
+    }
+    
+    TraceReader reader;
+    if (!trace_open(&reader, filename)) {
+        return false;
+    }
+    if (!reader.binary) {
+        printf("❌ Error: El barrido comparte la traza mapeada; conviértala antes con --convert.\n");
+        trace_close(&reader);
+        return false;
+    }
+    int max_page[MAX_PROCESSES + 1];
+    if (!trace_collect_processes(&reader, max_page)) {
+        trace_close(&reader);
+        return false;
+    }
+    
+    // Producto cartesiano de la malla sobre la configuración cargada
+    SimConfig base;
+    config_save(&base);
+    base.cores = 1;
+    int count = 1;
+    for (int a = 0; a < SWEEP_AXES; a++) {
+        if (axes[a].count > 0) count *= axes[a].count;
+    }
+    
+    Sweep sweep;
+    sweep.trace = &reader;
+    sweep.max_page = max_page;
+    sweep.runs = (SweepRun*)calloc(count, sizeof(SweepRun));
+    sweep.count = count;
+    sweep.next = 0;
+    sweep.done = 0;
+    for (int i = 0; i < count; i++) {
+        SimConfig *config = &sweep.runs[i].config;
+        *config = base;
+        int rest = i;
+        for (int a = SWEEP_AXES - 1; a >= 0; a--) {
+            if (axes[a].count == 0) continue;
+            const char *value = axes[a].values[rest % axes[a].count];
+            rest /= axes[a].count;
+            switch (a) {
+                case 0: config->ram_size = atoi(value); break;
+                case 1: config->swap_size = atoi(value); break;
+                case 2: config->page_size = atoi(value); break;
+                case 3: config->tlb_size = atoi(value); break;
+                default: strcpy(config->replacement, value); break;
             }
         }
     }
     
-    // Resumen de memoria
-    int ram_used = 0, swap_used = 0;
-    for (int i = 0; i < NUM_RAM_FRAMES; i++) {
-        if (mem_system->ram_frames[i].occupied) ram_used++;
+    // Las instancias simultáneas no pueden compartir el archivo de swap:
+    // cada configuración usa el suyo y lo borra al terminar
+    if (base.swap_file[0] != '\0') {
+        for (int i = 0; i < count; i++) {
+            snprintf(sweep.runs[i].config.swap_file, sizeof(base.swap_file), "%.200s.%d", 
+                     base.swap_file, i);
+        }
     }
-    for (int i = 0; i < NUM_SWAP_FRAMES; i++) {
-        if (mem_system->swap_frames[i].occupied) swap_used++;
+    // Lo mismo con el archivo de eventos, que sí se conserva
+    if (base.log_file[0] != '\0') {
+        for (int i = 0; i < count; i++) {
+            snprintf(sweep.runs[i].config.log_file, sizeof(base.log_file), "%.200s.%d", 
+                     base.log_file, i);
+        }
     }
     
-    printf("\n  MEMORIA:\n");
-    printf("  RAM: %d/%d marcos ocupados (%.1f%%)\n", 
-           ram_used, NUM_RAM_FRAMES, 
-           ((float)ram_used / NUM_RAM_FRAMES) * 100);
-    printf("  Swap: %d/%d marcos ocupados (%.1f%%)\n", 
-           swap_used, NUM_SWAP_FRAMES, 
-           ((float)swap_used / NUM_SWAP_FRAMES) * 100);
-}
-
-// Mostrar TLB
-void display_tlb() {
+#ifndef _WIN32
+    if (jobs < 1) jobs = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    if (jobs < 1) jobs = 1;
+    if (jobs > count) jobs = count;
+    
     printf("\n╔════════════════════════════════════════════════════════════╗\n");
-    printf("║           TLB (Translation Lookaside Buffer)              ║\n");
+    printf("║                BARRIDO DE PARÁMETROS                       ║\n");
     printf("╚════════════════════════════════════════════════════════════╝\n\n");
+    printf("  %-40s %s (%llu accesos)\n", "Traza:", filename, 
+           (unsigned long long)reader.header->record_count);
+    printf("  %-40s %s\n", "Malla:", grid_file);
+    printf("  %-40s %d\n", "Configuraciones:", count);
+    printf("  %-40s %d\n", "Hilos trabajadores:", jobs);
+    if (base.swap_file[0] != '\0') {
+        printf("  %-40s %s.N (uno por configuración)\n", "Archivo de swap:", base.swap_file);
+    }
+    if (base.log_file[0] != '\0') {
+        printf("  %-40s %s.N (uno por configuración)\n", "Archivo de eventos:", base.log_file);
+    }
+    printf("\n");
     
-    printf("  Tamaño de TLB: %d entradas\n\n", TLB_SIZE);
-    
-    printf("  %-10s %-8s %-12s %-12s %-10s\n", 
-           "Entrada", "PID", "Página", "Marco RAM", "Válido");
-    printf("  %s\n", "------------------------------------------------------------");
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+#ifdef _WIN32
+    sweep_worker(&sweep);
+#else
+    pthread_t *threads = (pthread_t*)malloc(jobs * sizeof(pthread_t));
+    int started = 0;
+    while (started < jobs && 
+           pthread_create(&threads[started], NULL, sweep_worker, &sweep) == 0) {
+        started++;
+    }
+    if (started == 0) sweep_worker(&sweep);
+    for (int t = 0; t < started; t++) {
+        pthread_join(threads[t], NULL);
+    }
+    free(threads);
+#endif
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    trace_close(&reader);
     
-    for (int i = 0; i < TLB_SIZE; i++) {
-        TLBEntry *entry = &mem_system->tlb[i];
-        
-        printf("  %-10d ", i);
-        
-        if (entry->valid) {
-            printf("%-8d %-12d %-12d %-10s\n", 
-                   entry->pid, entry->page_number, 
-                   entry->frame_number, "Sí");
-        } else {
-            printf("%-8s %-12s %-12s %-10s\n", 
-                   "-", "-", "-", "No");
-        }
+    bool ok = sweep_write_csv(csv_file, &sweep);
+    int failed = 0;
+    for (int i = 0; i < count; i++) {
+        if (strcmp(sweep.runs[i].status, "ok") != 0 || sweep.runs[i].errors > 0) failed++;
     }
+    free(sweep.runs);
     
-    printf("\n  Estadísticas TLB:\n");
-    printf("  Aciertos (hits): %d\n", mem_system->total_tlb_hits);
-    printf("  Fallos (misses): %d\n", mem_system->total_tlb_misses);
+    double elapsed = (double)(end.tv_sec - start.tv_sec) + 
+                     (double)(end.tv_nsec - start.tv_nsec) / 1e9;
+    printf("\n  %-40s %.3f s\n", "Tiempo del barrido:", elapsed);
+    if (failed > 0) {
+        printf("  ⚠️  %d configuraciones no terminaron bien (columna status / errors).\n", failed);
+    }
+    if (ok) {
+        printf("✓ %d filas escritas en %s\n", count, csv_file);
+    }
+    return ok && failed == 0;
+}
+
+// Página sin acceso vigente en un tiempo del árbol
+#define STACK_NO_PAGE UINT32_MAX
+
+static void fenwick_add(int32_t *tree, uint32_t size, uint32_t index, int32_t delta) {
+    for (; index <= size; index += index & (~index + 1)) {
+        tree[index] += delta;
+    }
+}
+
+static int32_t fenwick_sum(const int32_t *tree, uint32_t index) {
+    int32_t sum = 0;
+    for (; index > 0; index -= index & (~index + 1)) {
+        sum += tree[index];
+    }
+    return sum;
+}
+
+// Reservar el árbol para num_pages páginas; con el doble de tiempos que de
+// páginas la compactación cuesta O(1) amortizado por acceso
+static bool stack_init(StackDistance *sd, uint32_t num_pages) {
+    sd->capacity = num_pages > 512 ? num_pages * 2 : 1024;
+    sd->now = 0;
+    sd->live = 0;
+    sd->last = (uint32_t*)calloc(num_pages, sizeof(uint32_t));
+    sd->owner = (uint32_t*)malloc((sd->capacity + 1) * sizeof(uint32_t));
+    sd->tree = (int32_t*)calloc(sd->capacity + 1, sizeof(int32_t));
+    return sd->last && sd->owner && sd->tree;
+}
+
+static void stack_destroy(StackDistance *sd) {
+    free(sd->last);
+    free(sd->owner);
+    free(sd->tree);
+}
+
+// Renumerar los tiempos vigentes como 1..live sin cambiar su orden y
+// reconstruir el árbol en O(capacidad)
+static void stack_compact(StackDistance *sd) {
+    uint32_t next = 0;
+    for (uint32_t t = 1; t <= sd->now; t++) {
+        uint32_t page = sd->owner[t];
+        if (page == STACK_NO_PAGE) continue;
+        sd->owner[++next] = page;
+        sd->last[page] = next;
+    }
+    for (uint32_t t = 1; t <= sd->capacity; t++) {
+        if (t > next) sd->owner[t] = STACK_NO_PAGE;
+        sd->tree[t] = t <= next ? 1 : 0;
+    }
+    for (uint32_t t = 1; t <= sd->capacity; t++) {
+        uint32_t parent = t + (t & (~t + 1));
+        if (parent <= sd->capacity) sd->tree[parent] += sd->tree[t];
+    }
+    sd->now = next;
+}
+
+// Registrar un acceso a una página; retorna su distancia de pila
+// (1 = la misma página que el acceso anterior) o 0 si es el primero
+static uint32_t stack_access(StackDistance *sd, uint32_t page) {
+    if (sd->now == sd->capacity) stack_compact(sd);
     
-    int total_accesses = mem_system->total_tlb_hits + mem_system->total_tlb_misses;
-    if (total_accesses > 0) {
-        printf("  Tasa de aciertos: %.2f%%\n", 
-               ((float)mem_system->total_tlb_hits / total_accesses) * 100);
+    uint32_t distance = 0;
+    uint32_t previous = sd->last[page];
+    if (previous) {
+        // Marcas posteriores al acceso anterior = páginas distintas desde entonces
+        distance = sd->live - (uint32_t)fenwick_sum(sd->tree, previous) + 1;
+        fenwick_add(sd->tree, sd->capacity, previous, -1);
+        sd->owner[previous] = STACK_NO_PAGE;
+        sd->live--;
     }
+    
+    sd->now++;
+    sd->owner[sd->now] = page;
+    sd->last[page] = sd->now;
+    fenwick_add(sd->tree, sd->capacity, sd->now, 1);
+    sd->live++;
+    return distance;
 }
 
-// Mostrar estadísticas del sistema
-void display_statistics() {
-    printf("\n╔════════════════════════════════════════════════════════════╗\n");
-    printf("║                ESTADÍSTICAS DEL SISTEMA                    ║\n");
-    printf("╚════════════════════════════════════════════════════════════╝\n\n");
+// Hash para el muestreo espacial de SHARDS (splitmix64)
+static inline uint64_t mrc_hash(uint64_t key) {
+    key += 0x9e3779b97f4a7c15ULL;
+    key = (key ^ (key >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    key = (key ^ (key >> 27)) * 0x94d049bb133111ebULL;
+    return key ^ (key >> 31);
+}
+
+// Curva de fallos de LRU (fallos de página frente a marcos de RAM) en una
+// sola pasada: con el histograma de distancias de pila, los fallos con F
+// marcos son los primeros accesos más los de distancia > F. Con
+// MRC_SAMPLE_RATE < 1 solo se siguen las páginas cuyo hash cae bajo el
+// umbral (SHARDS) y distancias y cuentas se escalan por 1/tasa.
+bool mrc_trace(const char *filename, const char *csv_file) {
+    double rate = MRC_SAMPLE_RATE;
+    if (rate <= 0 || rate > 1) {
+        printf("❌ Error: MRC_SAMPLE_RATE debe estar entre 0 (excluido) y 1.\n");
+        return false;
+    }
     
-    // Calcular fragmentación interna
-    int internal_fragmentation = 0;
-    for (int i = 0; i < MAX_PROCESSES; i++) {
-        PCB *p = mem_system->processes[i];
-        if (p) {
-            int wasted = (p->num_pages * PAGE_SIZE) - p->size;
-            internal_fragmentation += wasted;
-        }
+    TraceReader reader;
+    if (!trace_open(&reader, filename)) {
+        return false;
+    }
+    int max_page[MAX_PROCESSES + 1];
+    if (!trace_collect_processes(&reader, max_page)) {
+        trace_close(&reader);
+        return false;
     }
     
-    // Calcular utilización de memoria
-    int ram_used = 0, swap_used = 0;
-    for (int i = 0; i < NUM_RAM_FRAMES; i++) {
-        if (mem_system->ram_frames[i].occupied) ram_used++;
+    // Páginas de todos los procesos en un espacio denso: base[pid] + página
+    uint64_t base[MAX_PROCESSES + 1];
+    uint64_t num_pages = 0;
+    for (int pid = 1; pid <= MAX_PROCESSES; pid++) {
+        base[pid] = num_pages;
+        num_pages += (uint64_t)(max_page[pid] + 1);
     }
-    for (int i = 0; i < NUM_SWAP_FRAMES; i++) {
-        if (mem_system->swap_frames[i].occupied) swap_used++;
+    if (num_pages == 0 || num_pages > UINT32_MAX / 4) {
+        printf("❌ Error: La traza no tiene accesos o tiene demasiadas páginas (%llu).\n", 
+               (unsigned long long)num_pages);
+        trace_close(&reader);
+        return false;
     }
     
-    float ram_utilization = ((float)ram_used / NUM_RAM_FRAMES) * 100;
-    float swap_utilization = ((float)swap_used / NUM_SWAP_FRAMES) * 100;
+    StackDistance sd;
+    double *histogram = (double*)calloc(num_pages + 1, sizeof(double));
+    if (!stack_init(&sd, (uint32_t)num_pages) || !histogram) {
+        printf("❌ Error: No hay memoria para %llu páginas.\n", (unsigned long long)num_pages);
+        stack_destroy(&sd);
+        free(histogram);
+        trace_close(&reader);
+        return false;
+    }
     
-    // Tiempo promedio de acceso (considerando TLB)
-    // Asumiendo: TLB hit = 1ns, TLB miss + RAM = 100ns, Page fault + Swap = 1000ns
-    int tlb_accesses = mem_system->total_tlb_hits + mem_system->total_tlb_misses;
-    float avg_access_time = 0;
+    uint64_t threshold = (uint64_t)(rate * (double)(1ULL << 24));
+    double weight = 1.0 / rate;
+    unsigned long long accesses = 0;
+    unsigned long long sampled = 0;
+    unsigned long long errors = 0;
+    double cold = 0;
     
-    if (tlb_accesses > 0) {
-        float hit_rate = (float)mem_system->total_tlb_hits / tlb_accesses;
-        float miss_rate = (float)mem_system->total_tlb_misses / tlb_accesses;
-        float page_fault_rate = (float)mem_system->total_page_faults / tlb_accesses;
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    TraceRecord record;
+    int parsed;
+    while ((parsed = trace_next(&reader, &record)) != 0) {
+        if (parsed < 0) {
+            errors++;
+            continue;
+        }
+        accesses++;
+        if (rate < 1 && 
+            (mrc_hash(((uint64_t)record.pid << 32) | (uint32_t)record.page_number) >> 40) >= threshold) {
+            continue;
+        }
+        sampled++;
         
-        avg_access_time = (hit_rate * 1) + (miss_rate * 100) + (page_fault_rate * 1000);
+        uint32_t distance = stack_access(&sd, (uint32_t)(base[record.pid] + record.page_number));
+        if (distance == 0) {
+            cold += weight;
+        } else {
+            uint64_t scaled = (uint64_t)(distance * weight);
+            if (scaled < 1) scaled = 1;
+            if (scaled > num_pages) scaled = num_pages;
+            histogram[scaled] += weight;
+        }
     }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    bool binary = reader.binary;
+    trace_close(&reader);
     
-    printf("  MÉTRICAS DE RENDIMIENTO:\n\n");
-    
-    printf("  %-40s %d\n", "Total de fallos de página:", mem_system->total_page_faults);
-    printf("  %-40s %d\n", "Total de operaciones de swap:", mem_system->total_swaps);
-    printf("  %-40s %.2f ns\n", "Tiempo promedio de acceso:", avg_access_time);
-    printf("  %-40s %d KB\n", "Fragmentación interna:", internal_fragmentation);
-    
-    printf("\n  UTILIZACIÓN DE MEMORIA:\n\n");
-    printf("  %-40s %.2f%%\n", "Utilización de RAM:", ram_utilization);
-    printf("  %-40s %.2f%%\n", "Utilización de Swap:", swap_utilization);
+    // SHARDS ajustado: la diferencia entre las muestras esperadas y las
+    // obtenidas se atribuye a la menor distancia
+    if (rate < 1) {
+        histogram[1] += ((double)accesses * rate - (double)sampled) * weight;
+    }
     
-    printf("\n  TLB:\n\n");
-    printf("  %-40s %d\n", "Aciertos en TLB:", mem_system->total_tlb_hits);
-    printf("  %-40s %d\n", "Fallos en TLB:", mem_system->total_tlb_misses);
+    uint64_t max_distance = 1;
+    double reuses = 0;
+    for (uint64_t d = 1; d <= num_pages; d++) {
+        if (histogram[d] != 0) max_distance = d;
+        reuses += histogram[d];
+    }
     
-    if (tlb_accesses > 0) {
-        printf("  %-40s %.2f%%\n", "Tasa de aciertos en TLB:", 
-               ((float)mem_system->total_tlb_hits / tlb_accesses) * 100);
+    // Fallos con F marcos = primeros accesos + reusos a distancia > F
+    uint64_t step = (max_distance + MRC_MAX_ROWS - 1) / MRC_MAX_ROWS;
+    FILE *file = fopen(csv_file, "w");
+    if (!file) {
+        printf("❌ Error: No se pudo crear el archivo '%s'.\n", csv_file);
+        stack_destroy(&sd);
+        free(histogram);
+        return false;
     }
+    fprintf(file, "frames,ram_kb,page_faults,miss_ratio\n");
     
-    printf("\n  PROCESOS:\n\n");
-    printf("  %-40s %d\n", "Procesos activos:", mem_system->num_processes);
+    int config_frames = PAGE_SIZE > 0 ? RAM_SIZE / PAGE_SIZE : 0;
+    double config_faults = 0;
+    double within = 0;
+    int rows = 0;
+    for (uint64_t frames = 1; frames <= max_distance; frames++) {
+        within += histogram[frames];
+        double faults = cold + reuses - within;
+        if (faults < 0) faults = 0;
+        if (faults > (double)accesses) faults = (double)accesses;
+        if ((int)frames == config_frames) config_faults = faults;
+        
+        if (frames % step == 0 || frames == max_distance) {
+            fprintf(file, "%llu,%llu,%.0f,%.6f\n", (unsigned long long)frames, 
+                    (unsigned long long)frames * PAGE_SIZE, faults, 
+                    accesses > 0 ? faults / accesses : 0.0);
+            rows++;
+        }
+    }
+    if ((uint64_t)config_frames > max_distance) config_faults = cold;
+    fclose(file);
     
-    // Tiempo de ejecución
-    time_t current_time = time(NULL);
-    int runtime = (int)difftime(current_time, mem_system->start_time);
-    printf("  %-40s %d segundos\n", "Tiempo de ejecución:", runtime);
-}
-
-// Mostrar logs
-void display_logs(int count) {
+    double elapsed = (double)(end.tv_sec - start.tv_sec) + 
+                     (double)(end.tv_nsec - start.tv_nsec) / 1e9;
     printf("\n╔════════════════════════════════════════════════════════════╗\n");
-    printf("║                    REGISTRO DE EVENTOS                     ║\n");
+    printf("║              CURVA DE FALLOS (LRU, UNA PASADA)             ║\n");
     printf("╚════════════════════════════════════════════════════════════╝\n\n");
-    
-    if (mem_system->log_count == 0) {
-        printf("  [No hay eventos registrados]\n");
-        return;
+    printf("  %-40s %s (%s)\n", "Traza:", filename, binary ? "binaria" : "texto");
+    printf("  %-40s %llu\n", "Accesos analizados:", accesses);
+    printf("  %-40s %llu\n", "Accesos con error:", errors);
+    if (rate < 1) {
+        printf("  %-40s %.4f (%llu accesos muestreados)\n", "Muestreo SHARDS:", rate, sampled);
     }
+    printf("  %-40s %u%s\n", "Páginas distintas:", sd.live, rate < 1 ? " (muestreadas)" : "");
+    printf("  %-40s %.0f\n", "Fallos obligatorios (primer acceso):", cold);
+    printf("  %-40s %llu\n", "Distancia de pila máxima (marcos):", 
+           (unsigned long long)max_distance);
+    printf("  %-40s %.3f s\n", "Tiempo del análisis:", elapsed);
+    if (elapsed > 0) {
+        printf("  %-40s %.0f accesos/s\n", "Rendimiento:", accesses / elapsed);
+    }
+    if (config_frames > 0) {
+        char label[64];
+        snprintf(label, sizeof(label), "Fallos con %d marcos (config.ini):", config_frames);
+        printf("  %-40s %.0f (%.2f%%)\n", label, config_faults, 
+               accesses > 0 ? config_faults * 100 / accesses : 0.0);
+    }
+    printf("✓ %d puntos de la curva escritos en %s\n", rows, csv_file);
     
-    int start = (count > mem_system->log_count) ? 0 : mem_system->log_count - count;
-    
-    printf("  Mostrando últimos %d eventos:\n\n", mem_system->log_count - start);
-    
-    for (int i = start; i < mem_system->log_count; i++) {
-        LogEntry *entry = &mem_system->logs[i];
-        struct tm *timeinfo = localtime(&entry->timestamp);
-        
-        printf("  [%02d:%02d:%02d] %s\n", 
-               timeinfo->tm_hour, timeinfo->tm_min, timeinfo->tm_sec,
-               entry->message);
+    stack_destroy(&sd);
+    free(histogram);
+    return true;
+}
+
+// ==================== BANCO DE DISPOSICIÓN ====================
+// --bench-layout compara la disposición anterior de las estructuras calientes
+// (entrada de tabla de páginas de 40 bytes y marco de 24 bytes, arreglos de
+// estructuras) con la actual (entrada empaquetada de 8 bytes con los ticks
+// aparte y tabla de marcos como estructura de arreglos). Se mide el recorrido
+// que hacen terminate_process y la reclamación: páginas residentes y sucias
+// de una tabla y marcos de un proceso. Se toma el mejor de varios recorridos.
+
+#define BENCH_LAYOUT_ROUNDS 5
+
+// Disposición anterior (solo para el banco)
+typedef struct {
+    int page_number;
+    int frame_number;
+    PageState state;
+    bool valid;
+    bool modified;
+    bool prefetched;
+    bool huge;
+    int swap_position;
+    unsigned long long last_access;
+    unsigned long long load_time;
+} LegacyPageTableEntry;
+
+typedef struct {
+    int pid;
+    int page_number;
+    bool occupied;
+    unsigned long long load_time;
+} LegacyFrame;
+
+typedef struct {
+    int entries;
+    LegacyPageTableEntry *legacy_ptes;
+    PageTableEntry *ptes;
+    LegacyFrame *legacy_frames;
+    FrameTable frames;
+} BenchLayout;
+
+static long bench_scan_legacy_ptes(const BenchLayout *bench) {
+    long count = 0;
+    for (int i = 0; i < bench->entries; i++) {
+        const LegacyPageTableEntry *entry = &bench->legacy_ptes[i];
+        count += entry->state == PAGE_IN_RAM && entry->modified;
     }
+    return count;
 }
 
-// Guardar logs en archivo
-void save_logs_to_file(const char *filename) {
-    FILE *file = fopen(filename, "w");
-    if (!file) {
-        printf("❌ Error: No se pudo crear el archivo de logs.\n");
-        return;
+static long bench_scan_ptes(const BenchLayout *bench) {
+    long count = 0;
+    for (int i = 0; i < bench->entries; i++) {
+        const PageTableEntry *entry = &bench->ptes[i];
+        count += entry->state == PAGE_IN_RAM && entry->modified;
+    }
+    return count;
+}
+
+static long bench_scan_legacy_frames(const BenchLayout *bench) {
+    long count = 0;
+    for (int i = 0; i < bench->entries; i++) {
+        count += bench->legacy_frames[i].occupied && bench->legacy_frames[i].pid == 3;
+    }
+    return count;
+}
+
+static long bench_scan_frames(const BenchLayout *bench) {
+    long count = 0;
+    for (int i = 0; i < bench->entries; i++) {
+        count += bench->frames.pid[i] == 3;
+    }
+    return count;
+}
+
+// Mejor tiempo por entrada (ns) de un recorrido; en *result queda su cuenta
+static double bench_best(long (*scan)(const BenchLayout*), const BenchLayout *bench, long *result) {
+    double best = 0;
+    for (int round = 0; round < BENCH_LAYOUT_ROUNDS; round++) {
+        struct timespec start, end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        *result = scan(bench);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        double ns = (double)(end.tv_sec - start.tv_sec) * 1e9 + (double)(end.tv_nsec - start.tv_nsec);
+        if (round == 0 || ns < best) best = ns;
+    }
+    return best / bench->entries;
+}
+
+// Comparar ambas disposiciones con el mismo contenido: la mitad de las
+// páginas en RAM (una de cada tres sucia) y marcos repartidos entre 8 procesos
+bool bench_layout(int entries) {
+    if (entries < 1 || entries > PTE_INDEX_MAX) {
+        printf("❌ Error: El banco admite entre 1 y %d entradas.\n", PTE_INDEX_MAX);
+        return false;
     }
     
-    fprintf(file, "========================================\n");
-    fprintf(file, "REGISTRO DE EVENTOS DEL SIMULADOR\n");
-    fprintf(file, "========================================\n\n");
+    BenchLayout bench;
+    bench.entries = entries;
+    bench.legacy_ptes = (LegacyPageTableEntry*)calloc(entries, sizeof(LegacyPageTableEntry));
+    bench.ptes = (PageTableEntry*)calloc(entries, sizeof(PageTableEntry));
+    bench.legacy_frames = (LegacyFrame*)calloc(entries, sizeof(LegacyFrame));
+    frame_table_init(&bench.frames, entries);
+    if (!bench.legacy_ptes || !bench.ptes || !bench.legacy_frames || 
+        !bench.frames.pid || !bench.frames.page_number || !bench.frames.load_time) {
+        printf("❌ Error: No hay memoria para %d entradas.\n", entries);
+        free(bench.legacy_ptes);
+        free(bench.ptes);
+        free(bench.legacy_frames);
+        frame_table_destroy(&bench.frames);
+        return false;
+    }
     
-    for (int i = 0; i < mem_system->log_count; i++) {
-        LogEntry *entry = &mem_system->logs[i];
-        struct tm *timeinfo = localtime(&entry->timestamp);
+    for (int i = 0; i < entries; i++) {
+        bool in_ram = (i & 1) == 0;
+        bool dirty = in_ram && i % 3 == 0;
+        LegacyPageTableEntry *legacy = &bench.legacy_ptes[i];
+        legacy->page_number = i;
+        legacy->frame_number = in_ram ? i / 2 : -1;
+        legacy->state = in_ram ? PAGE_IN_RAM : PAGE_IN_SWAP;
+        legacy->valid = in_ram;
+        legacy->modified = dirty;
+        legacy->swap_position = in_ram ? -1 : i / 2;
         
-        fprintf(file, "[%02d:%02d:%02d] %s\n", 
-                timeinfo->tm_hour, timeinfo->tm_min, timeinfo->tm_sec,
-                entry->message);
+        PageTableEntry *entry = &bench.ptes[i];
+        entry->frame_number = legacy->frame_number;
+        entry->state = legacy->state;
+        entry->valid = in_ram;
+        entry->modified = dirty;
+        entry->swap_position = legacy->swap_position;
+        
+        bench.legacy_frames[i].pid = i % 8;
+        bench.legacy_frames[i].page_number = i;
+        bench.legacy_frames[i].occupied = true;
+        bench.frames.pid[i] = i % 8;
+        bench.frames.page_number[i] = i;
     }
     
-    fclose(file);
-    printf("✓ Logs guardados en: %s\n", filename);
+    long legacy_count, count;
+    double legacy_pte_ns = bench_best(bench_scan_legacy_ptes, &bench, &legacy_count);
+    double pte_ns = bench_best(bench_scan_ptes, &bench, &count);
+    bool ok = legacy_count == count;
+    double legacy_frame_ns = bench_best(bench_scan_legacy_frames, &bench, &legacy_count);
+    double frame_ns = bench_best(bench_scan_frames, &bench, &count);
+    ok = ok && legacy_count == count;
+    
+    printf("\n╔════════════════════════════════════════════════════════════╗\n");
+    printf("║              DISPOSICIÓN DE LAS ESTRUCTURAS                ║\n");
+    printf("╚════════════════════════════════════════════════════════════╝\n\n");
+    printf("  %-40s %d\n", "Entradas por recorrido:", entries);
+    printf("  %-40s %d\n\n", "Recorridos (se toma el mejor):", BENCH_LAYOUT_ROUNDS);
+    printf("  %-22s %-12s %-12s %-12s %-12s %-8s\n", "Recorrido", "Bytes ant.", "Bytes act.", 
+           "ns/ent. ant.", "ns/ent. act.", "Mejora");
+    printf("  %s\n", "--------------------------------------------------------------------------------");
+    printf("  %-23s %-12zu %-12zu %-12.3f %-12.3f %.2fx\n", "Páginas sucias en RAM", 
+           sizeof(LegacyPageTableEntry), sizeof(PageTableEntry), legacy_pte_ns, pte_ns, 
+           pte_ns > 0 ? legacy_pte_ns / pte_ns : 0.0);
+    printf("  %-22s %-12zu %-12zu %-12.3f %-12.3f %.2fx\n", "Marcos de un proceso", 
+           sizeof(LegacyFrame), sizeof(int), legacy_frame_ns, frame_ns, 
+           frame_ns > 0 ? legacy_frame_ns / frame_ns : 0.0);
+    printf("\n  Bytes = los que lee el recorrido por entrada. Los ticks de la página\n");
+    printf("  (%zu bytes) van en un arreglo aparte que ningún recorrido lee.\n", sizeof(PageTableCold));
+    if (!ok) {
+        printf("❌ Error: Las dos disposiciones no dan el mismo resultado.\n");
+    }
+    
+    free(bench.legacy_ptes);
+    free(bench.ptes);
+    free(bench.legacy_frames);
+    frame_table_destroy(&bench.frames);
+    return ok;
+}
+
+// Mostrar uso de la línea de comandos
+void print_usage(const char *program) {
+    printf("Uso: %s [opciones]\n\n", program);
+    printf("  (sin opciones)        Modo interactivo con menú\n");
+    printf("  --replay <traza>      Reproducir una traza (texto o binaria) sin interacción\n");
+    printf("  --convert <txt> <bin> Convertir una traza de texto al formato binario\n");
+    printf("  --opt                 Con --replay, comparar contra OPT (Belady) en la misma traza\n");
+    printf("  --cores <n>           Con --replay, simular n núcleos (un hilo y una TLB por núcleo)\n");
+    printf("  --scale               Con --replay, medir la escalabilidad de 1 a CORES núcleos\n");
+    printf("  --sweep <malla> <csv> Con --replay, ejecutar cada configuración de la malla y\n");
+    printf("                        escribir una fila CSV por configuración\n");
+    printf("  --jobs <n>            Con --sweep, hilos trabajadores (por defecto, uno por CPU)\n");
+    printf("  --mrc <csv>           Con --replay, curva de fallos de LRU para todo tamaño de\n");
+    printf("                        RAM en una sola pasada (sin simular)\n");
+    printf("  --bench-layout [n]    Comparar la disposición anterior y la actual de las tablas\n");
+    printf("                        de páginas y de marcos recorriendo n entradas\n");
+    printf("  --help                Mostrar esta ayuda\n");
 }
 
 // Obtener entrada de usuario (entero)
@@ -1220,6 +7072,8 @@ void run_simulator() {
         print_menu();
         option = get_user_input_int("\nSeleccione una opción: ");
         
+        // kswapd solo reclama entre una opción y la siguiente
+        mm_lock();
         switch (option) {
             case 1: { // Crear proceso
                 clear_screen();
@@ -1323,49 +7177,43 @@ void run_simulator() {
                     break;
                 }
                 
-                printf("\n--- Simulando acceso a Página %d del Proceso %d ---\n\n", page, pid);
+                int write = get_user_input_int("Tipo de acceso (0 = lectura, 1 = escritura): ");
+                
+                printf("\n--- Simulando %s de Página %d del Proceso %d ---\n\n", 
+                       write ? "escritura" : "lectura", page, pid);
                 
-                // Incrementar accesos a memoria
-                mem_system->total_memory_accesses++;
+                PageTableEntry *entry = page_table_lookup(process, page);
+                int swap_position = entry ? entry->swap_position : -1;
+                bool untouched = !entry || entry->state == PAGE_FREE;
                 
-                // Buscar en TLB
-                int frame = tlb_lookup(pid, page);
+                AccessResult result = access_page(pid, page, write != 0);
+                entry = page_table_lookup(process, page);
                 
-                if (frame != -1) {
-                    printf("✓ TLB HIT: Página encontrada en TLB (Marco %d)\n", frame);
+                if (result == ACCESS_TLB_HIT) {
+                    printf("✓ TLB HIT: Página encontrada en TLB (Marco %d)\n", entry->frame_number);
                     printf("  Acceso directo a memoria física.\n");
-                    
-                    char msg[256];
-                    snprintf(msg, sizeof(msg), "Acceso a memoria: Proceso %d, Página %d - TLB HIT (Marco %d)", 
-                             pid, page, frame);
-                    add_log(msg);
                 } else {
                     printf("✗ TLB MISS: Página no encontrada en TLB\n");
                     printf("  Consultando tabla de páginas...\n\n");
                     
-                    PageTableEntry *entry = &process->page_table[page];
-                    
-                    if (entry->state == PAGE_IN_RAM) {
+                    if (result == ACCESS_PAGE_HIT) {
                         printf("✓ Página encontrada en RAM (Marco %d)\n", entry->frame_number);
                         printf("  Actualizando TLB...\n");
-                        
-                        tlb_update(pid, page, entry->frame_number);
-                        
-                        char msg[256];
-                        snprintf(msg, sizeof(msg), "Acceso a memoria: Proceso %d, Página %d - En RAM (Marco %d)", 
-                                 pid, page, entry->frame_number);
-                        add_log(msg);
-                    } else if (entry->state == PAGE_IN_SWAP) {
-                        printf("✗ PAGE FAULT: Página en Swap (posición %d)\n", entry->swap_position);
+                    } else if (result == ACCESS_PAGE_FAULT && untouched) {
+                        printf("✗ PAGE FAULT: Primer acceso a la página (sin materializar)\n");
+                        printf("  Creando su entrada y asignando un marco en cero...\n\n");
+                        printf("✓ Página ahora en RAM (Marco %d)\n", entry->frame_number);
+                        printf("  TLB actualizada.\n");
+                    } else if (result == ACCESS_PAGE_FAULT) {
+                        printf("✗ PAGE FAULT: Página en Swap (posición %d)\n", swap_position);
                         printf("  Iniciando swap in...\n\n");
-                        
-                        if (swap_in_page(pid, page)) {
-                            printf("✓ Swap in completado exitosamente.\n");
-                            printf("  Página ahora en RAM (Marco %d)\n", entry->frame_number);
-                            printf("  TLB actualizada.\n");
-                        } else {
-                            printf("❌ Error al realizar swap in.\n");
-                        }
+                        printf("✓ Swap in completado exitosamente.\n");
+                        printf("  Página ahora en RAM (Marco %d)\n", entry->frame_number);
+                        printf("  TLB actualizada.\n");
+                    } else if (entry && entry->state == PAGE_IN_SWAP) {
+                        printf("✗ PAGE FAULT: Página en Swap (posición %d)\n", swap_position);
+                        printf("  Iniciando swap in...\n\n");
+                        printf("❌ Error al realizar swap in.\n");
                     } else {
                         printf("❌ Página no presente en memoria.\n");
                     }
@@ -1385,11 +7233,6 @@ void run_simulator() {
             case 9: { // Ver logs
                 clear_screen();
                 int count = get_user_input_int("¿Cuántos eventos desea ver? (0 = todos): ");
-                
-                if (count == 0) {
-                    count = mem_system->log_count;
-                }
-                
                 display_logs(count);
                 pause_screen();
                 break;
@@ -1443,14 +7286,92 @@ void run_simulator() {
                 pause_screen();
                 break;
         }
+        mm_unlock();
+#ifndef _WIN32
+        if (__atomic_load_n(&mem_system->kswapd_woken, __ATOMIC_RELAXED)) sched_yield();
+#endif
     }
 }
 
 // ==================== FUNCIÓN PRINCIPAL ====================
 
 int main(int argc, char *argv[]) {
+    const char *replay_file = NULL;
+    bool compare_opt = false;
+    bool scale = false;
+    int cores = 0;
+    const char *grid_file = NULL;
+    const char *csv_file = NULL;
+    const char *mrc_file = NULL;
+    int jobs = 0;
+    
+    // Procesar argumentos
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            replay_file = argv[++i];
+        } else if (strcmp(argv[i], "--opt") == 0) {
+            compare_opt = true;
+        } else if (strcmp(argv[i], "--cores") == 0 && i + 1 < argc) {
+            cores = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--scale") == 0) {
+            scale = true;
+        } else if (strcmp(argv[i], "--sweep") == 0 && i + 2 < argc) {
+            grid_file = argv[++i];
+            csv_file = argv[++i];
+        } else if (strcmp(argv[i], "--mrc") == 0 && i + 1 < argc) {
+            mrc_file = argv[++i];
+        } else if (strcmp(argv[i], "--jobs") == 0 && i + 1 < argc) {
+            jobs = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--convert") == 0 && i + 2 < argc) {
+            return convert_trace(argv[i + 1], argv[i + 2]) ? 0 : 1;
+        } else if (strcmp(argv[i], "--bench-layout") == 0) {
+            int entries = 1 << 22;
+            if (i + 1 < argc && isdigit((unsigned char)argv[i + 1][0])) entries = atoi(argv[++i]);
+            return bench_layout(entries) ? 0 : 1;
+        } else if (strcmp(argv[i], "--help") == 0) {
+            print_usage(argv[0]);
+            return 0;
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    
+    if ((grid_file || mrc_file) && !replay_file) {
+        printf("❌ Error: --sweep y --mrc necesitan una traza (--replay).\n");
+        return 1;
+    }
+    
     // Cargar configuración
     load_config("config.ini");
+    if (cores > 0) CORES = cores;
+    if (CORES < 1) CORES = 1;
+#ifdef _WIN32
+    if (CORES > 1) {
+        printf("⚠️  La simulación multinúcleo no está disponible en Windows. Usando 1 núcleo.\n");
+        CORES = 1;
+    }
+#endif
+    
+    // Modo de reproducción de trazas (sin interacción)
+    if (replay_file) {
+        quiet_mode = true;
+        // Las mediciones no pagan el registro de aciertos y swaps salvo que se pida
+        strcpy(LOG_LEVEL, REPLAY_LOG_LEVEL);
+        if (mrc_file) return mrc_trace(replay_file, mrc_file) ? 0 : 1;
+        if (grid_file) return sweep_trace(replay_file, grid_file, csv_file, jobs) ? 0 : 1;
+        if (scale) return scale_trace(replay_file, CORES) ? 0 : 1;
+        return replay_trace(replay_file, compare_opt) ? 0 : 1;
+    }
+    
+    // En el modo interactivo hay un solo usuario y un solo núcleo
+    CORES = 1;
+    
+    // OPT necesita conocer el futuro: solo existe en reproducción de trazas
+    if (strcmp(REPLACEMENT, "OPT") == 0) {
+        printf("⚠️  OPT solo está disponible con --replay. Usando FIFO.\n");
+        strcpy(REPLACEMENT, "FIFO");
+    }
     
     // Inicializar sistema
     init_system();